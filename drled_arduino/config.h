@@ -20,6 +20,10 @@ namespace DevRelief {
             pixelType = NEO_GRB;
             maxBrightness=50;
             pixelsPerMeter = 30;
+            redBalance = 255;
+            greenBalance = 255;
+            blueBalance = 255;
+            maxMilliamps = 0;
         }
 
         ~LedPin() {
@@ -35,6 +39,12 @@ namespace DevRelief {
         uint16_t pixelType;
         uint8_t maxBrightness;
         uint16_t pixelsPerMeter;
+        // white balance.  255 is full brightness
+        uint8_t redBalance;
+        uint8_t greenBalance;
+        uint8_t blueBalance;
+        // estimated current limit for the pin.  0 is no limit
+        int maxMilliamps;
     };
 
     class ScriptDetails {
@@ -73,6 +83,9 @@ namespace DevRelief {
                 ipAddress = "unknown";
                 brightness = 40;
                 maxBrightness = 100;
+                gamma = 1;
+                maxMilliamps = 0;
+                milliampsPerChannel = 20;
                 buildVersion = BUILD_VERSION;
                 buildDate = BUILD_DATE;
                 buildTime = BUILD_TIME;
@@ -121,6 +134,15 @@ namespace DevRelief {
             void setBrightness(int b) { brightness = b;}
             int getMaxBrightness() const { return maxBrightness;}
             void setMaxBrightness(int b) { maxBrightness = b;}
+            // 1 is no gamma correction
+            double getGamma() const { return gamma;}
+            void setGamma(double g) { gamma = g;}
+            // estimated current limit of all pins.  0 is no limit
+            int getMaxMilliamps() const { return maxMilliamps;}
+            void setMaxMilliamps(int m) { maxMilliamps = m;}
+            // current of one LED color channel at full brightness
+            int getMilliampsPerChannel() const { return milliampsPerChannel;}
+            void setMilliampsPerChannel(int m) { milliampsPerChannel = m;}
 
             void clearScripts() {
                 scripts.clear();
@@ -177,6 +199,9 @@ namespace DevRelief {
             PtrList<ScriptDetails*>   scripts;
             int  brightness;
             int  maxBrightness;
+            double gamma;
+            int  maxMilliamps;
+            int  milliampsPerChannel;
             DECLARE_LOGGER();
             static Config* instance;
 
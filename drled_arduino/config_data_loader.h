@@ -47,6 +47,9 @@ class ConfigDataLoader : public DataLoader {
             config.clearPins();
             config.setBrightness(40);
             config.setMaxBrightness(100);
+            config.setGamma(1);
+            config.setMaxMilliamps(0);
+            config.setMilliampsPerChannel(20);
             addScripts(config);
             return true;
         }
@@ -174,6 +177,9 @@ class ConfigDataLoader : public DataLoader {
             config.setBrightness(object->getInt("brightness",config.getBrightness()));
             m_logger->debug(LM("get maxBrightness"));
             config.setMaxBrightness(object->getInt("maxBrightness",config.getMaxBrightness()));
+            config.setGamma(object->getFloat("gamma",config.getGamma()));
+            config.setMaxMilliamps(object->getInt("maxMilliamps",config.getMaxMilliamps()));
+            config.setMilliampsPerChannel(object->getInt("milliampsPerChannel",config.getMilliampsPerChannel()));
             EpochTime::Instance.setGmtOffsetMinutes(object->getInt("gmtOffsetMinutes",-5*60));
 
             JsonArray* pins = object->getArray("pins");
@@ -194,6 +200,10 @@ class ConfigDataLoader : public DataLoader {
                                 configPin->maxBrightness = pin->getInt("maxBrightness",40);
                                 configPin->pixelType = getPixelType(pin->getString("pixelType","NEO_GRP"));
                                 configPin->pixelsPerMeter = pin->getInt("pixelsPerMeter",30);
+                                configPin->redBalance = pin->getInt("redBalance",255);
+                                configPin->greenBalance = pin->getInt("greenBalance",255);
+                                configPin->blueBalance = pin->getInt("blueBalance",255);
+                                configPin->maxMilliamps = pin->getInt("maxMilliamps",0);
                             }
                         } else {
                             m_logger->error("pin is not an Object");
@@ -223,19 +233,26 @@ class ConfigDataLoader : public DataLoader {
             json->setString("ipAddress",config.getAddr());
             json->setInt("brightness",config.getBrightness());
             json->setInt("maxBrightness",config.getMaxBrightness());
+            json->setFloat("gamma",config.getGamma());
+            json->setInt("maxMilliamps",config.getMaxMilliamps());
+            json->setInt("milliampsPerChannel",config.getMilliampsPerChannel());
             JsonArray* pins = root->createArray();
             json->set("pins",pins);
             m_logger->debug(LM("filling pins from config"));
             config.getPins().each( [this,logger=m_logger,pins](LedPin* pin) {
                 logger->debug(LM("\thandle pin 0x%04X"),pin); 
                 logger->debug(LM("\tnumber %d"),pin->number); 
-                JsonObject* pinElement = new JsonObject((pins->getRoot()));
+                JsonObject* pinElement = pins->getRoot()->createObject();
                 pinElement->setInt("number",pin->number);
                 pinElement->setInt("ledCount",pin->ledCount);
                 pinElement->setBool("reverse",pin->reverse);
                 pinElement->setInt("maxBrightness",pin->maxBrightness);
                 pinElement->setString("pixelType",getPixelType(pin->pixelType));
                 pinElement->setInt("pixelsPerMeter",pin->pixelsPerMeter);
+                pinElement->setInt("redBalance",pin->redBalance);
+                pinElement->setInt("greenBalance",pin->greenBalance);
+                pinElement->setInt("blueBalance",pin->blueBalance);
+                pinElement->setInt("maxMilliamps",pin->maxMilliamps);
                 pins->addItem(pinElement);
             });
             m_logger->debug(LM("pins done"));
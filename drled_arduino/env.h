@@ -56,6 +56,20 @@
     #define ENV_PROD
     #define RUN_TESTS 0
     #define LOGGING_ON 0
+#elif defined(HOST_TESTS)
+    // host test runner (host/drled_tests.cpp) compiles every suite
+    #define ENV_DEV
+    #define DEBUG
+    #define RUN_TESTS 1
+    #define RUN_STRING_TESTS 1
+    #define RUN_JSON_TESTS 1
+    #define RUN_ANIMATION_TESTS 1
+    #define RUN_COLOR_TESTS 1
+    #define SCRIPT_LOADER_TESTS 1
+    #define RUN_API_TESTS 1
+    #define RUN_APP_STATE_TESTS 1
+    #define RUN_SCRIPT_TESTS 1
+    #define RUN_TIMER_TESTS 1
 #else
     #define ENV_DEV
     #define DEBUG
@@ -66,6 +80,7 @@
     #define RUN_STRING_TESTS 0
     #define RUN_JSON_TESTS 0
     #define RUN_ANIMATION_TESTS 0
+    #define RUN_COLOR_TESTS 0
     #define SCRIPT_LOADER_TESTS 0
     #define RUN_API_TESTS 0
     #define RUN_APP_STATE_TESTS 0
@@ -37,9 +37,9 @@ class DataLoader {
             if (m_fileSystem.read(path,buffer)){
                 m_logger->always("file: %s",buffer.text());
                 JsonParser parser;
-                JsonRoot* root = parser.read(buffer.text());
+                // the json strings point into the file buffer so it is kept until the root is destroyed
+                JsonRoot* root = parser.readInPlace((char*)buffer.text());
                 if (root) {
-                    buffer.clear(); // free file read memory before parsing json
                     bool result = reader(root->asObject());
                     root->destroy();
                     return result;
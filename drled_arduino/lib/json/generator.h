@@ -182,19 +182,46 @@ public:
             writeText("null");
             return;
         }
-        writeText("\"");
-        const char * end = strchr(txt,'\"');
-        while(end != NULL) {
-            size_t len = end-txt+1;
-            char* pos = m_buf.increaseLength(len+1);
-            memcpy(pos,txt,len);
-            pos[len] = '\\';
-            pos[len+1] = '\"';
-            txt = end+1;
-            end = strchr(txt,'\"');
+        writeString(txt);
+    }
+
+    // the parser unescapes strings so they are escaped again here
+    void writeEscaped(const char * text) {
+        if (text == NULL) {
+            return;
         }
-        writeText(txt);
-        writeText("\"");
+        const char * start = text;
+        for(const char * c=text;*c != 0;c++) {
+            const char * escape = NULL;
+            switch(*c) {
+                case '"': escape = "\\\""; break;
+                case '\\': escape = "\\\\"; break;
+                case '\n': escape = "\\n"; break;
+                case '\r': escape = "\\r"; break;
+                case '\t': escape = "\\t"; break;
+                case '\b': escape = "\\b"; break;
+                case '\f': escape = "\\f"; break;
+            }
+            if (escape == NULL && (unsigned char)*c < 0x20) {
+                snprintf(m_tmp,32,"\\u%04x",(int)*c);
+                escape = m_tmp;
+            }
+            if (escape != NULL) {
+                writeChars(start,c-start);
+                writeText(escape);
+                start = c+1;
+            }
+        }
+        writeText(start);
+    }
+
+    void writeChars(const char * text, size_t len) {
+        if (len == 0) {
+            return;
+        }
+        char *pos = m_buf.increaseLength(len);
+        memcpy(pos,text,len);
+        pos[len] = 0;
     }
     
     void writeText(const char * text) {
@@ -214,7 +241,7 @@ public:
 
     void writeString(const char * text) {
         writeText("\"");
-        writeText(text);
+        writeEscaped(text);
         writeText("\"");
     }
 
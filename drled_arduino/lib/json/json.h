@@ -3,6 +3,7 @@
 
 #include "../log/logger.h"
 #include "../util/drstring.h"
+#include "../util/arena.h"
 #include "./json_interface.h"
 
 namespace DevRelief {
@@ -10,6 +11,12 @@ namespace DevRelief {
 
 class JsonArray;
 class JsonObject;
+class JsonRoot;
+class JsonString;
+class JsonInt;
+class JsonFloat;
+class JsonBool;
+class JsonNull;
 
 class JsonBase : public IJsonElement {
     public:
@@ -25,6 +32,16 @@ class JsonBase : public IJsonElement {
             delete this;
         }
 
+        // elements are allocated from their root's arena by the JsonRoot::create...() methods
+        static void* operator new(size_t size) { return ::operator new(size);}
+        static void* operator new(size_t size, JsonRoot* root);
+        static void operator delete(void* ptr) {
+            if (ptr != NULL && !Arena::isArenaMemory(ptr)) {
+                ::operator delete(ptr);
+            }
+        }
+        static void operator delete(void* ptr, JsonRoot* root) { operator delete(ptr);}
+
         bool isArray() override { return false;}
         bool isObject() override { return false;}
         bool isString() override { return false;}
@@ -55,18 +72,28 @@ class JsonBase : public IJsonElement {
         DECLARE_LOGGER();
 };
 
+const size_t JSON_ARENA_CHUNK_SIZE=512;
+
+/* elements and strings of a JsonRoot are allocated from its arena.
+ * if all of them are in the arena, the destructors are not run and
+ * the arena is freed in one step.
+ */
 class JsonRoot : public JsonBase {
     public:
         JsonRoot() : JsonBase() {
             m_value = NULL;
             m_nextJsonId = 1;
+            m_heapElements = false;
+            m_sourceText = NULL;
+            m_sourceLength = 0;
+            m_arena.setChunkSize(JSON_ARENA_CHUNK_SIZE);
             setJsonId(this);
         }
 
 
 
         virtual ~JsonRoot() {
-            if (m_value && m_value->getRoot() == this){
+            if (m_value && m_value->getRoot() == this && m_heapElements){
                 m_value->destroy();
             }
         }
@@ -75,11 +102,38 @@ class JsonRoot : public JsonBase {
             element->setJsonId(m_nextJsonId++);
         }
 
+        // size of the first chunk.  the parser reserves it based on the text length
+        void reserve(size_t size) { m_arena.reserve(size);}
+        void* allocate(size_t size) { return m_arena.allocate(size);}
+        bool ownsMemory(const void* ptr) const { return m_arena.contains(ptr);}
+        const Arena& getArena() const { return m_arena;}
+
+        // an element that was not allocated from the arena needs its destructor run
+        void addHeapElement() { m_heapElements = true;}
+
+        // text the root's strings may point into.  see JsonParser::readInPlace()
+        void setSourceText(const char * text, size_t len) {
+            m_sourceText = text;
+            m_sourceLength = len;
+        }
+
+        bool isSourceText(const char * ptr) const {
+            return m_sourceText != NULL && ptr >= m_sourceText && ptr < m_sourceText+m_sourceLength;
+        }
+
         char * allocString(const char * val, size_t len) {
             if (len == 0) {
                 return NULL;
             }
-            char * str = (char*)malloc(len+1);
+            if ((isSourceText(val) || m_arena.contains(val)) && val[len] == 0) {
+                // already owned by this root
+                return (char*)val;
+            }
+            char * str = (char*)m_arena.allocate(len+1);
+            if (str == NULL) {
+                str = (char*)malloc(len+1);
+                m_heapElements = true;
+            }
             strncpy(str,val,len+1);
             str[len] = 0;
         
@@ -87,7 +141,7 @@ class JsonRoot : public JsonBase {
         }
 
         void freeString(const char * val) {
-            if (val != NULL) {
+            if (val != NULL && !m_arena.contains(val) && !isSourceText(val)) {
                 free((void*)val);
             }
         }
@@ -102,6 +156,17 @@ class JsonRoot : public JsonBase {
 
         JsonObject* createObject();
         JsonArray* createArray();
+        JsonString* createString(const char * value);
+        JsonString* createString(const char * value, size_t len);
+        JsonInt* createInt(int value);
+        JsonFloat* createFloat(double value);
+        JsonBool* createBool(bool value);
+        JsonNull* createNull();
+
+        // returns an element owned by this root.  an element in another root's arena
+        // or with strings in its source text is copied since that memory is freed with the other root.
+        IJsonElement* adopt(IJsonElement* element);
+        IJsonElement* copy(IJsonElement* element);
 
         IJsonElement* getTopElement(){
             return m_value;
@@ -141,6 +206,10 @@ class JsonRoot : public JsonBase {
     protected:
         int m_nextJsonId;
         IJsonElement * m_value;
+        Arena m_arena;
+        bool m_heapElements;
+        const char * m_sourceText;
+        size_t m_sourceLength;
 };
 
 class JsonElement : public JsonBase {
@@ -149,7 +218,9 @@ class JsonElement : public JsonBase {
         JsonElement(JsonRoot* root,JsonType t) :m_root(root) {
             m_type = t;
             root->setJsonId(this);
-
+            if (!root->ownsMemory(this)) {
+                root->addHeapElement();
+            }
         }
         virtual ~JsonElement() {
          }
@@ -437,10 +508,13 @@ class JsonObject : public JsonElement {
             }
         }
 
+        // jsonId is only for debugging.  like the generator, it is not passed to the lambda
         void eachProperty(auto lambda) {
             JsonProperty* prop = m_firstProperty;
             while(prop != NULL) {
-                lambda(prop->getName(),prop->getValue());
+                if (strcmp(prop->getName(),"jsonId")!=0) {
+                    lambda(prop->getName(),prop->getValue());
+                }
                 prop = prop->getNext();
             }
         }
@@ -459,15 +533,21 @@ class JsonObject : public JsonElement {
             return prop;
         }
 
-        JsonProperty* set(const char *nameStart,size_t nameLen,JsonElement * value){
-            value->setRoot(m_root);
-            JsonProperty* prop = new JsonProperty(m_root,nameStart,nameLen,value);
-            add(prop);
+        // nameStart does not need to be null terminated.  an existing property is replaced
+        JsonProperty* set(const char *nameStart,size_t nameLen,IJsonElement * value){
+            value = m_root->adopt(value);
+            JsonProperty* prop = getProperty(nameStart,nameLen);
+            if (prop != NULL) {
+                prop->setValue(value);
+            } else {
+                prop = new(m_root) JsonProperty(m_root,nameStart,nameLen,value);
+                add(prop);
+            }
             return prop;
         }
 
         JsonObject* createObject(const char * propertyName) {
-            JsonObject* obj = new JsonObject(getRoot());
+            JsonObject* obj = getRoot()->createObject();
             set(propertyName,obj);
             return obj;
         }
@@ -475,15 +555,13 @@ class JsonObject : public JsonElement {
         JsonArray* createArray(const char * propertyName);
         
         JsonProperty* set(const char *name,IJsonElement * value){
-            if (value->getRoot() != m_root) {
-                value->setRoot(m_root);
-            }
+            value = m_root->adopt(value);
             JsonProperty*prop = getProperty(name);
             if (prop != NULL) {
                 prop->setValue(value);
             } else {
 
-                prop = new JsonProperty(m_root,name,value);
+                prop = new(m_root) JsonProperty(m_root,name,value);
                 add(prop);
               
             }
@@ -491,19 +569,19 @@ class JsonObject : public JsonElement {
         }
 
         JsonProperty* setBool(const char *name,bool value) {
-            JsonBool * pval = new JsonBool(getRoot(),value);
+            JsonBool * pval = getRoot()->createBool(value);
             return set(name,pval);
         }
         JsonProperty* setInt(const char *name,int value) {
-            JsonInt * pval = new JsonInt(getRoot(),value);
+            JsonInt * pval = getRoot()->createInt(value);
             return set(name,pval);
         }
         JsonProperty* setString(const char *name,const char *value) {
-            JsonString * pval = new JsonString(getRoot(),value);
+            JsonString * pval = getRoot()->createString(value);
             return set(name,pval);
         }
         JsonProperty* setFloat(const char *name,double value) {
-            JsonFloat * pval = new JsonFloat(getRoot(),value);
+            JsonFloat * pval = getRoot()->createFloat(value);
             return set(name,pval);
         }
 
@@ -544,6 +622,16 @@ class JsonObject : public JsonElement {
             }
             return NULL;
         }
+
+        JsonProperty * getProperty(const char * name,size_t nameLen) {
+            for(JsonProperty*prop=m_firstProperty;prop!=NULL;prop=prop->getNext()){
+                const char * propName = prop->getName();
+                if (strncmp(propName,name,nameLen)==0 && propName[nameLen]==0) {
+                    return prop;
+                }
+            }
+            return NULL;
+        }
         JsonProperty* getFirstProperty() { return m_firstProperty;}
 
         bool hasProperty(const char * name) { return getProperty(name);}
@@ -660,8 +748,8 @@ class JsonArray : public JsonElement {
             }
         }
         JsonArrayItem* addItem(IJsonElement * value){
-            value->setRoot(m_root);
-            JsonArrayItem* item = new JsonArrayItem(m_root,value);
+            value = m_root->adopt(value);
+            JsonArrayItem* item = new(m_root) JsonArrayItem(m_root,value);
             if (m_firstItem == NULL) {
                 m_firstItem = item;
             } else {
@@ -671,22 +759,22 @@ class JsonArray : public JsonElement {
         }
 
         JsonObject* addNewObject() {
-            JsonObject* obj = new JsonObject(getRoot());
+            JsonObject* obj = getRoot()->createObject();
             addItem(obj);
             return obj;
         }
 
         JsonArrayItem* addString(const char * val){
-            return addItem(new JsonString(getRoot(),val));
+            return addItem(getRoot()->createString(val));
         }
         JsonArrayItem* addInt(int val){
-            return addItem(new JsonInt(getRoot(),val));
+            return addItem(getRoot()->createInt(val));
         }
         JsonArrayItem* addFloat(double val){
-            return addItem(new JsonFloat(getRoot(),val));
+            return addItem(getRoot()->createFloat(val));
         }
         JsonArrayItem* addBool(bool val){
-            return addItem(new JsonBool(getRoot(),val));
+            return addItem(getRoot()->createBool(val));
         }
 
         int getCount() { return m_firstItem == NULL ? 0 : m_firstItem->getCount();}
@@ -714,11 +802,71 @@ class JsonArray : public JsonElement {
         JsonArrayItem * m_firstItem;
     };
 
+        void* JsonBase::operator new(size_t size, JsonRoot* root) {
+            void* ptr = root->allocate(size);
+            return ptr ? ptr : ::operator new(size);
+        }
+
         JsonObject* JsonRoot::createObject(){
-            return new JsonObject(this);
+            return new(this) JsonObject(this);
         }
         JsonArray* JsonRoot::createArray() {
-            return new JsonArray(this);
+            return new(this) JsonArray(this);
+        }
+        JsonString* JsonRoot::createString(const char * value) {
+            return new(this) JsonString(this,value);
+        }
+        JsonString* JsonRoot::createString(const char * value, size_t len) {
+            return new(this) JsonString(this,value,len);
+        }
+        JsonInt* JsonRoot::createInt(int value) {
+            return new(this) JsonInt(this,value);
+        }
+        JsonFloat* JsonRoot::createFloat(double value) {
+            return new(this) JsonFloat(this,value);
+        }
+        JsonBool* JsonRoot::createBool(bool value) {
+            return new(this) JsonBool(this,value);
+        }
+        JsonNull* JsonRoot::createNull() {
+            return new(this) JsonNull(this);
+        }
+
+        IJsonElement* JsonRoot::adopt(IJsonElement* element) {
+            JsonRoot* from = element->getRoot();
+            if (from == this) {
+                return element;
+            }
+            if (from != NULL && (from->ownsMemory(element) || from->m_sourceText != NULL)) {
+                return copy(element);
+            }
+            element->setRoot(this);
+            m_heapElements = true;
+            return element;
+        }
+
+        IJsonElement* JsonRoot::copy(IJsonElement* element) {
+            if (element->isObject()) {
+                JsonObject* obj = createObject();
+                element->asObject()->eachProperty([&](auto&& name, auto&& value){
+                    obj->set(name,copy(value));
+                });
+                return obj;
+            } else if (element->isArray()) {
+                JsonArray* array = createArray();
+                element->asArray()->each([&](auto&& value){
+                    array->addItem(copy(value));
+                });
+                return array;
+            }
+            IJsonValueElement* value = element->asValue();
+            switch(element->getType()) {
+                case JSON_STRING: return createString(value->getString(NULL));
+                case JSON_INTEGER: return createInt(value->getInt(0));
+                case JSON_FLOAT: return createFloat(value->getFloat(0));
+                case JSON_BOOLEAN: return createBool(value->getBool(false));
+                default: return createNull();
+            }
         }
         JsonObject* JsonRoot::getTopObject() {
             if (m_value == NULL) {
@@ -735,7 +883,7 @@ class JsonArray : public JsonElement {
         }
         
         JsonArray* JsonObject::createArray(const char * propertyName){
-            JsonArray* array = new JsonArray(getRoot());
+            JsonArray* array = getRoot()->createArray();
             set(propertyName,array);
             return array;
         }
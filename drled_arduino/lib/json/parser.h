@@ -10,6 +10,9 @@
 
 namespace DevRelief {
 
+// the first arena chunk of a parsed root has this many bytes for each character of text
+const size_t JSON_ARENA_BYTES_PER_CHAR=8;
+
 
 class TokenParser {
     public:
@@ -132,7 +135,7 @@ class TokenParser {
             m_pos += 1;
             start = m_pos;
             while(m_pos[len] != '"' && m_pos[len] != 0){
-                if (m_pos[len] == '\\'){
+                if (m_pos[len] == '\\' && m_pos[len+1] != 0){
                     len += 2;
                 } else {
                     len += 1;
@@ -146,6 +149,53 @@ class TokenParser {
             return false;
         }
 
+        // replaces escape sequences in the first len characters of text and returns the new length.
+        // \uXXXX becomes UTF-8.  surrogate pairs are not combined.
+        static size_t unescape(char * text, size_t len) {
+            char * out = text;
+            const char * in = text;
+            const char * end = text+len;
+            while(in < end) {
+                char c = *in++;
+                if (c != '\\' || in >= end) {
+                    *out++ = c;
+                    continue;
+                }
+                c = *in++;
+                if (c == 'n') {
+                    *out++ = '\n';
+                } else if (c == 'r') {
+                    *out++ = '\r';
+                } else if (c == 't') {
+                    *out++ = '\t';
+                } else if (c == 'b') {
+                    *out++ = '\b';
+                } else if (c == 'f') {
+                    *out++ = '\f';
+                } else if (c == 'u') {
+                    unsigned int code = 0;
+                    for(int digit=0;digit<4 && in < end && isxdigit(*in);digit++) {
+                        char h = *in++;
+                        code = code*16 + (isdigit(h) ? h-'0' : (h|0x20)-'a'+10);
+                    }
+                    if (code < 0x80) {
+                        *out++ = (char)code;
+                    } else if (code < 0x800) {
+                        *out++ = (char)(0xC0 | (code>>6));
+                        *out++ = (char)(0x80 | (code&0x3F));
+                    } else {
+                        *out++ = (char)(0xE0 | (code>>12));
+                        *out++ = (char)(0x80 | ((code>>6)&0x3F));
+                        *out++ = (char)(0x80 | (code&0x3F));
+                    }
+                } else {
+                    // \" \\ and \/
+                    *out++ = c;
+                }
+            }
+            return out-text;
+        }
+
         const char * getPos() { return m_pos;}
         const char * getTokPos() { return m_tokPos;}
 
@@ -161,11 +211,12 @@ class TokenParser {
             return m_pos-m_data+len;
         }
         int getCurrentLine(){
-            char * nl = strchr(m_data,'\n');
+            // strings before m_pos may be terminated in place so strchr() cannot be used
             int p = 1;
-            while(nl > 0 && nl <= m_pos)  {
-                nl = strchr(nl+1,'\n');
-                p++;
+            for(const char * c=m_data;c<m_pos;c++) {
+                if (*c == '\n') {
+                    p++;
+                }
             }
             return p;
         }
@@ -173,7 +224,7 @@ class TokenParser {
         int getLineCount(){
             const char * nl = strchr(m_data,'\n');
             int p = 1;
-            while(nl > 0)  {
+            while(nl != NULL)  {
                 nl = strchr(nl+1,'\n');
                 p++;
             }
@@ -220,6 +271,7 @@ public:
         SET_LOGGER(JsonParserLogger);
         m_errorMessage = NULL;
         m_hasError = false;
+        m_inPlace = false;
         m_root = NULL;
     }    
 
@@ -228,6 +280,20 @@ public:
 
 
     JsonRoot* read(const char * data) {
+        m_inPlace = false;
+        return parse(data);
+    }
+
+    // strings are unescaped and terminated in data and the json elements point to them.
+    // data must not change or be freed until the root is destroyed.
+    JsonRoot* readInPlace(char * data) {
+        m_inPlace = true;
+        JsonRoot* root = parse(data);
+        m_inPlace = false;
+        return root;
+    }
+
+    JsonRoot* parse(const char * data) {
         m_logger->debug("parsing %s",data);
         
         m_errorMessage = NULL;
@@ -239,6 +305,11 @@ public:
         if (data == NULL) {
             return root;
         }
+        size_t length = strlen(data);
+        if (m_inPlace) {
+            root->setSourceText(data,length);
+        }
+        root->reserve(length*JSON_ARENA_BYTES_PER_CHAR);
         
         TokenParser tokParser(data);
         m_logger->never("created TokenParser");
@@ -289,13 +360,13 @@ public:
         }  else if (next == TOK_FLOAT) {
             elem = parseFloat(tok);
         } else if (next == TOK_NULL) {
-            elem = new JsonNull(m_root);
+            elem = m_root->createNull();
             skipToken(tok,TOK_NULL);
         } else if (next == TOK_TRUE) {
-            elem = new JsonBool(m_root,true);
+            elem = m_root->createBool(true);
             skipToken(tok,TOK_TRUE);
         } else if (next == TOK_FALSE) {
-            elem = new JsonBool(m_root,false);
+            elem = m_root->createBool(false);
             skipToken(tok,TOK_FALSE);
         }
         if (elem == NULL) {
@@ -331,18 +402,35 @@ public:
         return false;
     }
 
+    // returns the text of a string token with escapes replaced.
+    // the root uses the text without a copy if it is in the root's arena or source text
+    const char * unescapeString(const char * start, size_t& len) {
+        char * text = NULL;
+        if (m_inPlace) {
+            text = (char*)start;
+        } else if (memchr(start,'\\',len) != NULL) {
+            text = m_root->allocString(start,len);
+        } else {
+            return start;
+        }
+        len = TokenParser::unescape(text,len);
+        text[len] = 0;
+        return text;
+    }
+
     IJsonElement* parseString(TokenParser& tok) {
         const char * nameStart;
         size_t nameLen;
         if(tok.nextString(nameStart,nameLen)){
-           return new JsonString(m_root,nameStart,nameLen);
+           const char * text = unescapeString(nameStart,nameLen);
+           return m_root->createString(text,nameLen);
         }
         return NULL;
     }
     IJsonElement* parseInt(TokenParser& tok) {
         int val=0;
         if(tok.nextInt(val)){
-            return new JsonInt(m_root,val);
+            return m_root->createInt(val);
         }
         return NULL;
     }
@@ -350,7 +438,7 @@ public:
     IJsonElement* parseFloat(TokenParser& tok) {
         double val=0;
         if(tok.nextFloat(val)){
-            return new JsonFloat(m_root,val);
+            return m_root->createFloat(val);
         }
         return NULL;
     }
@@ -361,12 +449,13 @@ public:
             m_logger->debug("\t{ not found");
             return NULL;
         }
-        JsonObject* obj = new JsonObject(m_root);
+        JsonObject* obj = m_root->createObject();
         const char * nameStart;
         size_t nameLen;
         m_logger->debug("\tread string");
 
         while(tok.nextString(nameStart,nameLen)){
+            nameStart = unescapeString(nameStart,nameLen);
             m_logger->debug("\tgot string");
             m_logger->debug("\t\t len=%d",nameLen);
             if (nameStart != NULL) {
@@ -387,8 +476,11 @@ public:
                 return NULL;
             }
             m_logger->debug("got val");
-            DRString name(nameStart,nameLen);
-            obj->set(name,val);
+            if (nameLen > 0) {
+                obj->set(nameStart,nameLen,val);
+            } else {
+                obj->set("",val);
+            }
             skipOptional(tok,TOK_COMMA);
         }
 
@@ -404,7 +496,7 @@ public:
         if (!skipToken(tok,TOK_ARRAY_START)) {
             return NULL;
         }
-        JsonArray* arr = new JsonArray(m_root);
+        JsonArray* arr = m_root->createArray();
         TokenType peek = tok.peek();
         if (peek == TOK_ARRAY_END) {
             // empty array
@@ -440,6 +532,7 @@ public:
     private:
         DECLARE_LOGGER();
         bool        m_hasError;
+        bool        m_inPlace;
         JsonRoot* m_root;
         int m_errorLineNumber;
         int m_errorCharacter;
@@ -0,0 +1,221 @@
+#ifndef JSON_STREAM_SCANNER_H
+#define JSON_STREAM_SCANNER_H
+
+#include "../log/logger.h"
+#include "../file_system.h"
+
+namespace DevRelief {
+
+const size_t JSON_STREAM_CHUNK_SIZE=64;
+// longer property names are truncated when they are compared by scanObject()
+const size_t JSON_STREAM_NAME_LENGTH=32;
+
+// counts of what a parsed value would hold.  used to estimate memory before it is parsed
+struct JsonTextStats {
+    size_t elementCount;
+    size_t textLength;
+};
+
+// position of a value in the file
+struct JsonTextRange {
+    size_t start;
+    size_t length;
+};
+
+/* JsonStreamScanner reads json from a file a few bytes at a time.
+ * it finds where values start and end without creating json elements
+ * so a large file can be parsed one value at a time.
+ */
+class JsonStreamScanner {
+    public:
+        JsonStreamScanner(File& file) : m_file(file) {
+            SET_LOGGER(JsonParserLogger);
+            m_pos = 0;
+            m_chunkStart = 0;
+            m_chunkLength = 0;
+            m_file.seek(0,SeekSet);
+        }
+
+        void seek(size_t pos) {
+            m_pos = pos;
+            m_chunkStart = pos;
+            m_chunkLength = 0;
+            m_file.seek(pos,SeekSet);
+        }
+
+        // file position of the next character.  call peek() first to skip whitespace
+        size_t getPos() const { return m_pos;}
+
+        // reads part of the file that was already scanned.  text is not null terminated
+        bool readText(const JsonTextRange& range, char * text) {
+            m_file.seek(range.start,SeekSet);
+            size_t length = m_file.read((uint8_t*)text,range.length);
+            m_file.seek(m_chunkStart+m_chunkLength,SeekSet);
+            return length == range.length;
+        }
+
+        // the next character that is not whitespace.  0 at the end of the file
+        char peek() {
+            char c = current();
+            while(c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                m_pos++;
+                c = current();
+            }
+            return c;
+        }
+
+        bool skip(char c) {
+            if (peek() != c) {
+                return false;
+            }
+            m_pos++;
+            return true;
+        }
+
+        // reads a string into text.  longer strings are truncated to maxLength-1 characters
+        bool readString(char * text, size_t maxLength, JsonTextStats& stats) {
+            if (!skip('"')) {
+                return false;
+            }
+            size_t len = 0;
+            char c = current();
+            while(c != '"' && c != 0) {
+                if (c == '\\') {
+                    m_pos++;
+                    c = current();
+                    if (c == 0) {
+                        return false;
+                    }
+                }
+                if (len+1 < maxLength) {
+                    text[len] = c;
+                }
+                len++;
+                m_pos++;
+                c = current();
+            }
+            if (maxLength > 0) {
+                text[len < maxLength ? len : maxLength-1] = 0;
+            }
+            stats.textLength += len+1;
+            return skip('"');
+        }
+
+        // skips one value and adds what it contains to stats
+        bool skipValue(JsonTextStats& stats) {
+            char c = peek();
+            stats.elementCount++;
+            if (c == '{') {
+                m_pos++;
+                if (skip('}')) {
+                    return true;
+                }
+                do {
+                    if (!readString(NULL,0,stats) || !skip(':') || !skipValue(stats)) {
+                        return false;
+                    }
+                } while(skip(','));
+                return skip('}');
+            } else if (c == '[') {
+                m_pos++;
+                if (skip(']')) {
+                    return true;
+                }
+                do {
+                    if (!skipValue(stats)) {
+                        return false;
+                    }
+                } while(skip(','));
+                return skip(']');
+            } else if (c == '"') {
+                return readString(NULL,0,stats);
+            }
+            // number, true, false or null
+            size_t start = m_pos;
+            while(isalnum(c) || c == '-' || c == '+' || c == '.') {
+                m_pos++;
+                c = current();
+            }
+            if (m_pos == start) {
+                m_logger->error("unexpected character '%c' at %d",c,m_pos);
+                return false;
+            }
+            return true;
+        }
+
+        // scans the object at pos.  propertyReader(range,isArray) is called for each property and
+        // itemReader(range) for each item of the array named arrayName.  the readers can move
+        // the scanner.  it continues after the property or item that was read.
+        bool scanObject(size_t pos, const char * arrayName, auto&& propertyReader, auto&& itemReader) {
+            JsonTextStats stats = {0,0};
+            seek(pos);
+            if (!skip('{')) {
+                return false;
+            }
+            if (skip('}')) {
+                return true;
+            }
+            do {
+                char name[JSON_STREAM_NAME_LENGTH];
+                JsonTextRange range;
+                peek();
+                range.start = m_pos;
+                if (!readString(name,sizeof(name),stats) || !skip(':')) {
+                    return false;
+                }
+                bool isArray = strcmp(name,arrayName)==0 && peek() == '[';
+                if (isArray) {
+                    m_pos++;
+                    if (!skip(']')) {
+                        do {
+                            JsonTextRange item;
+                            peek();
+                            item.start = m_pos;
+                            if (!skipValue(stats)) {
+                                return false;
+                            }
+                            item.length = m_pos-item.start;
+                            if (!itemReader(item)) {
+                                return false;
+                            }
+                            seek(item.start+item.length);
+                        } while(skip(','));
+                        if (!skip(']')) {
+                            return false;
+                        }
+                    }
+                } else if (!skipValue(stats)) {
+                    return false;
+                }
+                range.length = m_pos-range.start;
+                if (!propertyReader(range,isArray)) {
+                    return false;
+                }
+                seek(range.start+range.length);
+            } while(skip(','));
+            return skip('}');
+        }
+
+    private:
+        char current() {
+            if (m_pos >= m_chunkStart+m_chunkLength) {
+                // characters are read in order so the file is already at m_pos
+                m_chunkStart = m_pos;
+                m_chunkLength = m_file.read(m_chunk,JSON_STREAM_CHUNK_SIZE);
+                if (m_chunkLength == 0) {
+                    return 0;
+                }
+            }
+            return (char)m_chunk[m_pos-m_chunkStart];
+        }
+
+        File& m_file;
+        uint8_t m_chunk[JSON_STREAM_CHUNK_SIZE];
+        size_t m_pos;
+        size_t m_chunkStart;
+        size_t m_chunkLength;
+        DECLARE_LOGGER();
+};
+
+}
+#endif
@@ -3,7 +3,12 @@
 #include <math.h>
 
 #include "../log/logger.h"
+#include "../util/fixed.h"
 
+// INTEGER_COLOR 1 converts between HSL and RGB with integer kernels instead of floating point.
+#ifndef INTEGER_COLOR
+#define INTEGER_COLOR 1
+#endif
 
 
 namespace DevRelief {
@@ -94,7 +99,7 @@ namespace DevRelief {
     };
 
  
-    CHSL RGBToHSL(const CRGB&rgb)
+    CHSL RGBToHSLFloat(const CRGB&rgb)
     {
        // double r = rgb.red/255.0;
        // double g = rgb.green/255.0;
@@ -130,7 +135,43 @@ namespace DevRelief {
         return CHSL(h*360,s*100,l*100);
     }
 
-    float HueToRGB(float v1, float v2, float vH) {
+    /* Same result as RGBToHSLFloat() using integers.  Every value is a ratio of
+     * the 0-255 channels so the divisions are done on integers and
+     * truncate like the double to int conversion.
+     */
+    CHSL RGBToHSLInt(const CRGB& rgb) {
+        int r = rgb.red;
+        int g = rgb.green;
+        int b = rgb.blue;
+        int maxValue = r > g ? (r > b ? r : b) : (g > b ? g : b);
+        int minValue = r < g ? (r < b ? r : b) : (g < b ? g : b);
+        int sum = maxValue + minValue;
+        int lightness = sum*100/510;
+        if (maxValue == minValue) {
+            return CHSL(0,0,lightness);
+        }
+        int d = maxValue - minValue;
+        int saturation = d*100/(sum > 255 ? 510-sum : sum);
+        int hue;
+        if (maxValue == r) {
+            hue = (60*(g-b) + (g < b ? 360*d : 0))/d;
+        } else if (maxValue == g) {
+            hue = (60*(b-r) + 120*d)/d;
+        } else {
+            hue = (60*(r-g) + 240*d)/d;
+        }
+        return CHSL(hue,saturation,lightness);
+    }
+
+    CHSL RGBToHSL(const CRGB& rgb) {
+#if INTEGER_COLOR==1
+        return RGBToHSLInt(rgb);
+#else
+        return RGBToHSLFloat(rgb);
+#endif
+    }
+
+    template<typename T> T HueToRGB(T v1, T v2, T vH) {
         if (vH < 0)
             vH += 1;
 
@@ -144,42 +185,150 @@ namespace DevRelief {
             return v2;
 
         if ((3 * vH) < 2)
-            return (v1 + (v2 - v1) * ((2.0f / 3) - vH) * 6);
+            return (v1 + (v2 - v1) * (T(2.0f / 3) - vH) * 6);
 
         return v1;
     }
 
-    CRGB HSLToRGB(const CHSL& hsl) {
-        //m_logger->debug(hsl to rgb (%d,%d,%d)",(int)hsl.hue,(int)hsl.saturation,(int)hsl.lightness);
+    // T is float or Fixed.  HSLToRGB() uses Fixed if FIXED_POINT is 1
+    template<typename T> CRGB HSLToRGBWith(const CHSL& hsl) {
         unsigned char r = 0;
         unsigned char g = 0;
         unsigned char b = 0;
 
-        float h = hsl.hue/360.0;
-        float s = 1.0*hsl.saturation/100.0;
-        float l = 1.0*hsl.lightness/100.0;
+        T h = toReal<T>(hsl.hue,360);
+        T s = toReal<T>(hsl.saturation,100);
+        T l = toReal<T>(hsl.lightness,100);
         if (s == 0)
         {
-            r = g = b = (unsigned char)(l * 255);
+            r = g = b = (unsigned char)(int)(l * 255);
         }
         else
         {
-            float v1, v2;
-            float hue = (float)h;
+            T v1, v2;
 
-            v2 = (l < 0.5) ? (l * (1 + s)) : ((l + s) - (l * s));
+            v2 = (l < T(0.5)) ? (l * (1 + s)) : ((l + s) - (l * s));
             v1 = 2 * l - v2;
 
-            r = (unsigned char)(255 * HueToRGB(v1, v2, hue + (1.0f / 3)));
-            g = (unsigned char)(255 * HueToRGB(v1, v2, hue));
-            b = (unsigned char)(255 * HueToRGB(v1, v2, hue - (1.0f / 3)));
+            r = (unsigned char)(int)(255 * HueToRGB<T>(v1, v2, h + T(1.0f / 3)));
+            g = (unsigned char)(int)(255 * HueToRGB<T>(v1, v2, h));
+            b = (unsigned char)(int)(255 * HueToRGB<T>(v1, v2, h - T(1.0f / 3)));
         }
 
         CRGB rgb(r, g, b);
-        //m_logger->debug("hsl (%f,%f,%f)->rgb(%d,%d,%d)",(int)h,s,l,rgb.red,rgb.green,rgb.blue);
         return rgb;
     }
 
+    // x*255/600000 as a multiply and shift.  exact for x <= 600000
+    const uint64_t HSL_CHANNEL_SCALE = ((uint64_t)255<<48)/600000+1;
+
+    /* Integer HSL to RGB.  lightness and saturation are scaled to 0-10000 and
+     * each channel is linear in the hue within a 60 degree sector so a
+     * channel is (v1*60 + (v2-v1)*sectorHue)*255/(60*10000).
+     */
+    uint8_t hueChannel(int32_t v1, int32_t v2, int hue) {
+        if (hue < 0) { hue += 360;}
+        if (hue >= 360) { hue -= 360;}
+        int32_t value;
+        if (hue < 60) {
+            value = v1*60 + (v2-v1)*hue;
+        } else if (hue < 180) {
+            value = v2*60;
+        } else if (hue < 240) {
+            value = v1*60 + (v2-v1)*(240-hue);
+        } else {
+            value = v1*60;
+        }
+        return (uint8_t)(((uint64_t)value*HSL_CHANNEL_SCALE)>>48);
+    }
+
+    CRGB HSLToRGBInt(const CHSL& hsl) {
+        int32_t l = hsl.lightness;
+        int32_t s = hsl.saturation;
+        if (s == 0) {
+            uint8_t v = (uint8_t)(l*255/100);
+            return CRGB(v,v,v);
+        }
+        int32_t v2 = l < 50 ? l*(100+s) : (l+s)*100 - l*s;
+        int32_t v1 = l*200 - v2;
+        int hue = hsl.hue;
+        return CRGB(hueChannel(v1,v2,hue+120),hueChannel(v1,v2,hue),hueChannel(v1,v2,hue-120));
+    }
+
+    /* Per channel lookup tables for the bytes sent to a strip.  Each table is
+     * gamma correction, then brightness, then white balance.  The tables are
+     * only rebuilt when one of them changes.
+     * Brightness and balance are 0-255 and scale like Adafruit_NeoPixel (value*(b+1))>>8
+     * so a gamma of 1 and balance of 255 is the same as the driver's brightness.
+     */
+    class OutputTransform {
+        public:
+            OutputTransform() {
+                m_gamma = 1;
+                m_brightness = 255;
+                m_balance[0] = m_balance[1] = m_balance[2] = 255;
+                build();
+            }
+
+            void setGamma(double gamma) {
+                if (gamma <= 0) { gamma = 1;}
+                if (gamma != m_gamma) {
+                    m_gamma = gamma;
+                    build();
+                }
+            }
+
+            void setBrightness(uint8_t brightness) {
+                if (brightness != m_brightness) {
+                    m_brightness = brightness;
+                    build();
+                }
+            }
+
+            void setWhiteBalance(uint8_t red, uint8_t green, uint8_t blue) {
+                if (red != m_balance[0] || green != m_balance[1] || blue != m_balance[2]) {
+                    m_balance[0] = red;
+                    m_balance[1] = green;
+                    m_balance[2] = blue;
+                    build();
+                }
+            }
+
+            double getGamma() const { return m_gamma;}
+            uint8_t getBrightness() const { return m_brightness;}
+
+            uint8_t red(uint8_t value) const { return m_table[0][value];}
+            uint8_t green(uint8_t value) const { return m_table[1][value];}
+            uint8_t blue(uint8_t value) const { return m_table[2][value];}
+            CRGB apply(const CRGB& color) const { return CRGB(red(color.red),green(color.green),blue(color.blue));}
+
+        private:
+            void build() {
+                for(int i=0;i<256;i++) {
+                    int value = m_gamma == 1 ? i : (int)(pow(i/255.0,m_gamma)*255+0.5);
+                    value = (value*(m_brightness+1)) >> 8;
+                    for(int c=0;c<3;c++) {
+                        m_table[c][i] = (value*(m_balance[c]+1)) >> 8;
+                    }
+                }
+            }
+
+            double m_gamma;
+            uint8_t m_brightness;
+            uint8_t m_balance[3];
+            uint8_t m_table[3][256];
+    };
+
+    CRGB HSLToRGB(const CHSL& hsl) {
+#if INTEGER_COLOR==1
+        return HSLToRGBInt(hsl);
+#elif FIXED_POINT==1
+        return HSLToRGBWith<Fixed>(hsl);
+#else
+        return HSLToRGBWith<float>(hsl);
+#endif
+    }
+
 
     
 }
@@ -16,6 +16,7 @@
 
 
 #include "../log/interface.h"
+#include "../util/list.h"
 #include "./color.h"
 
 namespace DevRelief {
@@ -53,17 +54,123 @@ HSLOperation TextToHSLOP(const char * text) {
 
 class CompoundLedStrip;
 
+// setHSL() and fillHSL() do not change a hue, saturation or lightness that is HSL_UNSET
+const int16_t HSL_UNSET=-1;
+
+// hue, saturation and lightness arrays for writeHSL().
+// a NULL array leaves that channel unchanged for every LED.
+class HSLSpan {
+    public:
+        HSLSpan(const int16_t* hue, const int16_t* saturation, const int16_t* lightness) {
+            m_hue = hue;
+            m_saturation = saturation;
+            m_lightness = lightness;
+        }
+
+        int16_t getHue(int i) const { return m_hue ? m_hue[i] : HSL_UNSET;}
+        int16_t getSaturation(int i) const { return m_saturation ? m_saturation[i] : HSL_UNSET;}
+        int16_t getLightness(int i) const { return m_lightness ? m_lightness[i] : HSL_UNSET;}
+
+        // the same arrays starting "offset" values later
+        HSLSpan from(int offset) const {
+            return HSLSpan(m_hue ? m_hue+offset : NULL,
+                m_saturation ? m_saturation+offset : NULL,
+                m_lightness ? m_lightness+offset : NULL);
+        }
+    private:
+        const int16_t* m_hue;
+        const int16_t* m_saturation;
+        const int16_t* m_lightness;
+};
+
+/* The driver buffer of a physical strip.  HSLStrip writes RGB bytes straight
+ * into it instead of calling setColor() through every strip between them.
+ */
+class PixelBuffer {
+    public:
+        PixelBuffer(Adafruit_NeoPixel* controller, neoPixelType pixelType, const OutputTransform* transform, int maxMilliamps, bool reverse) {
+            m_transform = transform;
+            m_pixels = controller->getPixels();
+            m_count = controller->numPixels();
+            // same offsets and bytes per pixel as Adafruit_NeoPixel::updateType()
+            m_rOffset = (pixelType >> 4) & 0b11;
+            m_gOffset = (pixelType >> 2) & 0b11;
+            m_bOffset = pixelType & 0b11;
+            m_bytesPerPixel = ((pixelType >> 6) & 0b11) == m_rOffset ? 3 : 4;
+            m_reverse = reverse;
+            m_maxMilliamps = maxMilliamps;
+            m_channelTotal = 0;
+            for(int i=0;i<m_count;i++) {
+                uint8_t* pixel = m_pixels + i*m_bytesPerPixel;
+                m_channelTotal += pixel[m_rOffset] + pixel[m_gOffset] + pixel[m_bOffset];
+            }
+        }
+
+        void destroy() { delete this;}
+
+        int getCount() const { return m_count;}
+
+        // the strip's output transform and color order are applied here.
+        // the channel total is kept up to date for the power limit
+        void setColor(int index, const CRGB& color) {
+            uint8_t* pixel = m_pixels + (m_reverse ? m_count-index-1 : index)*m_bytesPerPixel;
+            uint8_t red = m_transform->red(color.red);
+            uint8_t green = m_transform->green(color.green);
+            uint8_t blue = m_transform->blue(color.blue);
+            m_channelTotal += red + green + blue - pixel[m_rOffset] - pixel[m_gOffset] - pixel[m_bOffset];
+            pixel[m_rOffset] = red;
+            pixel[m_gOffset] = green;
+            pixel[m_bOffset] = blue;
+        }
+
+        // estimated current of the bytes in the buffer.  milliampsPerChannel is the current of one channel at 255
+        uint32_t getMilliamps(int milliampsPerChannel) const { return m_channelTotal*milliampsPerChannel/255;}
+        // 0 if the strip does not have a limit
+        int getMaxMilliamps() const { return m_maxMilliamps;}
+
+        // multiply every byte by scale/256
+        void scale(uint16_t scale) {
+            m_channelTotal = 0;
+            for(int i=0;i<m_count;i++) {
+                uint8_t* pixel = m_pixels + i*m_bytesPerPixel;
+                pixel[m_rOffset] = (pixel[m_rOffset]*scale) >> 8;
+                pixel[m_gOffset] = (pixel[m_gOffset]*scale) >> 8;
+                pixel[m_bOffset] = (pixel[m_bOffset]*scale) >> 8;
+                m_channelTotal += pixel[m_rOffset] + pixel[m_gOffset] + pixel[m_bOffset];
+            }
+        }
+
+    private:
+        const OutputTransform* m_transform;
+        uint8_t* m_pixels;
+        int m_count;
+        uint8_t m_bytesPerPixel;
+        uint8_t m_rOffset;
+        uint8_t m_gOffset;
+        uint8_t m_bOffset;
+        bool m_reverse;
+        int m_maxMilliamps;
+        uint32_t m_channelTotal;
+};
+
 class IHSLStrip {
     public:
         virtual void setHue(int index, int16_t hue, HSLOperation op=REPLACE)=0;
         virtual void setSaturation(int index, int16_t saturation, HSLOperation op=REPLACE)=0;
         virtual void setLightness(int index, int16_t lightness, HSLOperation op=REPLACE)=0;
         virtual void setRGB(int index, const CRGB& rgb, HSLOperation op=REPLACE)=0;
+        virtual void setHSL(int index, int16_t hue, int16_t saturation, int16_t lightness, HSLOperation op=REPLACE)=0;
+        // set "count" LEDs starting at index to the same value
+        virtual void fillHSL(int index, int count, int16_t hue, int16_t saturation, int16_t lightness, HSLOperation op=REPLACE)=0;
+        // set "count" LEDs starting at index to values 0...count-1 of the span
+        virtual void writeHSL(int index, int count, const HSLSpan& values, HSLOperation op=REPLACE)=0;
         virtual int getCount()=0;
         virtual int getStart()=0;
         virtual void clear()=0;
         virtual void show()=0;
         virtual int getPixelsPerMeter()=0;
+        // LED i is shown at i+rotation.  LEDs past the end wrap to the start
+        virtual void setRotation(int rotation)=0;
 
 };
 
@@ -84,11 +191,16 @@ class DRLedStrip {
 
         virtual void clear() =0;
         virtual void setBrightness(uint16_t brightness)=0;
-        virtual void setColor(uint16_t index,const CRGB& color)=0;
+        virtual void setColor(uint32_t index,const CRGB& color)=0;
         virtual int getLEDCount()=0;
         virtual void show()=0;
+        // only LEDs first-last changed since the last show.  strips that cannot show part of the LEDs show all of them
+        virtual void showRange(int first, int last) { show();}
+        // add the driver buffers of this strip's LEDs in order.  false if a strip changes
+        // indexes or colors so LEDs must be set with setColor()
+        virtual bool getPixelBuffers(PtrList<PixelBuffer*>& buffers, bool reverse=false) { return false;}
 
-        virtual void setColor(uint16_t index, CHSL& color) {
+        virtual void setColor(uint32_t index, CHSL& color) {
             return setColor(index,HSLToRGB(color));
         }
 
@@ -106,9 +218,12 @@ class AdafruitLedStrip : public DRLedStrip {
         :DRLedStrip(pixelsPerMeter) {
             SET_LOGGER(AdafruitLogger);
             m_logger->debug("create AdafruitLedStrip %d %d",pin,ledCount);
+            m_pixelType = pixelType;
+            m_maxMilliamps = 0;
             
+            // brightness is in m_transform.  the controller does not scale colors
             m_controller = new Adafruit_NeoPixel(ledCount,pin,pixelType+NEO_KHZ800);
-            m_controller->setBrightness(40);
+            m_transform.setBrightness(40);
             m_controller->begin();
         }
 
@@ -126,14 +241,23 @@ class AdafruitLedStrip : public DRLedStrip {
             m_controller->clear();
         };
         virtual void setBrightness(uint16_t brightness) {
-            m_controller->setBrightness(brightness);
+            m_transform.setBrightness(brightness > 255 ? 255 : brightness);
+        }
+
+        // estimated current limit for this strip.  0 is no limit
+        void setPowerLimit(int maxMilliamps) { m_maxMilliamps = maxMilliamps;}
+
+        // gamma and white balance for this strip.  brightness is set with setBrightness()
+        void setOutput(double gamma, uint8_t redBalance, uint8_t greenBalance, uint8_t blueBalance) {
+            m_transform.setGamma(gamma);
+            m_transform.setWhiteBalance(redBalance,greenBalance,blueBalance);
         }
 
-        virtual void setColor(uint16_t index, const CRGB& color){
+        virtual void setColor(uint32_t index, const CRGB& color){
             if (index == 0) {
                 m_logger->debug("setColor  %02X,%02X,%02X",color.red,color.green,color.blue);
             }
-            m_controller->setPixelColor(index,m_controller->Color(color.red,color.green,color.blue));
+            m_controller->setPixelColor(index,m_transform.red(color.red),m_transform.green(color.green),m_transform.blue(color.blue));
         }
 
         virtual int getLEDCount() { return m_controller->numPixels();}
@@ -144,9 +268,17 @@ class AdafruitLedStrip : public DRLedStrip {
             m_controller->show();
         }
 
+        bool getPixelBuffers(PtrList<PixelBuffer*>& buffers, bool reverse) override {
+            buffers.add(new PixelBuffer(m_controller,m_pixelType,&m_transform,m_maxMilliamps,reverse));
+            return true;
+        }
+
         virtual CompoundLedStrip* getCompoundLedStrip() { return NULL;}
     protected:
         Adafruit_NeoPixel * m_controller;
+        neoPixelType m_pixelType;
+        OutputTransform m_transform;
+        int m_maxMilliamps;
 };
 
 class PhyisicalLedStrip : public AdafruitLedStrip {
@@ -160,117 +292,171 @@ class PhyisicalLedStrip : public AdafruitLedStrip {
             if (brightness > m_maxBrightness) {
                 brightness = m_maxBrightness;
             }
-            m_controller->setBrightness(brightness);
+            AdafruitLedStrip::setBrightness(brightness);
         }
 
     private:
         uint8_t m_maxBrightness;
 };
 
+/* Any number of strips used as one strip.  m_offsets[i] is the index of strip i's
+ * first LED and m_offsets[count] is the total.  Component strips must not change
+ * their LED count after they are added.
+ */
 class CompoundLedStrip : public DRLedStrip {
     public:
         CompoundLedStrip(int pixelsPerMeter) : DRLedStrip(pixelsPerMeter) {
-            strips[0] = NULL;
-            strips[1] = NULL;
-            strips[2] = NULL;
-            strips[3] = NULL;
-            count = 0;
+            m_strips = NULL;
+            m_offsets = (uint32_t*)malloc(sizeof(uint32_t));
+            m_offsets[0] = 0;
+            m_count = 0;
+            m_lastStrip = 0;
             m_logger->info("create CompoundLedStrip");
         }
 
         ~CompoundLedStrip() {
             m_logger->debug("delete CompoundLedStrip");
-            for(int i=0;i<count;i++) {
+            for(int i=0;i<m_count;i++) {
                 m_logger->debug("\tdelete component LedStrip %d",i);
-                delete strips[i];
+                delete m_strips[i];
             }
+            free(m_strips);
+            free(m_offsets);
         }
 
         /* this always returns the value of the first strip which may result
          * in incorrect calculations if multiple strips exist with different values */
         int getPixelsPerMeter() override {
-            if (count == 0) { return 0;}
-            return strips[0]->getPixelsPerMeter();
+            if (m_count == 0) { return 0;}
+            return m_strips[0]->getPixelsPerMeter();
         }
 
         void add(DRLedStrip * strip) {
-            if (count < 4) {
-                strips[count++] = strip;
-            } else {
-                m_logger->error("too many strips added to CompoundLedStrip");
+            if (strip == NULL) {
+                m_logger->error("NULL strip added to CompoundLedStrip");
+                return;
             }
+            m_strips = (DRLedStrip**)realloc(m_strips,sizeof(DRLedStrip*)*(m_count+1));
+            m_offsets = (uint32_t*)realloc(m_offsets,sizeof(uint32_t)*(m_count+2));
+            m_strips[m_count] = strip;
+            m_offsets[m_count+1] = m_offsets[m_count] + strip->getLEDCount();
+            m_count++;
         }
 
-        
+        int getStripCount() const { return m_count;}
+
         void clear() {
-            m_logger->debug("clear() %d components",count);
-            for(int i=0;i<count;i++) {
-                if (strips[i] == NULL) {
-                    m_logger->error("NULL component script %d",i);
-                } else {
-                    //m_logger->debug("clear strip %d",i);
-                    strips[i]->clear();
-                }
+            m_logger->debug("clear() %d components",m_count);
+            for(int i=0;i<m_count;i++) {
+                m_strips[i]->clear();
             }
         };
         virtual void setBrightness(uint16_t brightness) {
-            for(int i=0;i<count;i++) {
-                strips[i]->setBrightness(brightness);
+            for(int i=0;i<m_count;i++) {
+                m_strips[i]->setBrightness(brightness);
             }
         };
 
-        virtual void setColor(uint16_t index,const CRGB& color)  {
-            int strip = 0;
-            uint16_t oindex = index;
-            while(strip < count && strip < 4 && strips[strip] != NULL && index >= strips[strip]->getLEDCount()) {
-                index -= strips[strip]->getLEDCount();
-                strip++;
-            }
-            if (strip >= count || strip >= 4) {
-                m_logger->error("strip too big %d %d",strip,oindex);
+        virtual void setColor(uint32_t index,const CRGB& color)  {
+            int strip = findStrip(index);
+            if (strip < 0) {
+                m_logger->error("strip too big %d",index);
                 return;
             }
+            m_strips[strip]->setColor(index-m_offsets[strip],color);
+        };
 
-            if (strips[strip] == NULL) {
-                m_logger->error("missing strip %d %d",oindex,strip);
-                return;
+        virtual int getLEDCount() {
+            return m_offsets[m_count];
+        }
+
+        virtual void show() {
+            m_logger->debug("show() %d",m_count);
+            for(int i=0;i<m_count;i++) {
+                m_strips[i]->show();
             }
+        }
 
-            // if (index == 0) {
-            //     m_logger->error("set color %d %d %d %d: %d,%d,%d",index,count,strips[strip]->getCount(),strip,color.red,color.green,color.blue);
-            // }
-            if (index<strips[strip]->getLEDCount()){
-                strips[strip]->setColor(index,color);
-            } else {
-                m_logger->error("bad index %d %d %d",index,strip,(strips[strip] == NULL ? -1 : strips[strip]->getLEDCount()));
+        // only show the component strips with an LED between first and last
+        virtual void showRange(int first, int last) {
+            if (first < 0) { first = 0;}
+            int strip = findStrip(first);
+            for(int i=strip;i>=0 && i<m_count && m_offsets[i] <= (uint32_t)last;i++) {
+                m_strips[i]->show();
             }
-        };
-        virtual int getLEDCount() {
-            size_t ledcount = 0;
-            for(int i=0;i<count;i++) {
-                if (strips[i] == NULL) {
-                    m_logger->error("strip %d is NULL",i);
+        }
+
+        bool getPixelBuffers(PtrList<PixelBuffer*>& buffers, bool reverse) override {
+            if (reverse) { return false;}
+            for(int i=0;i<m_count;i++) {
+                if (!m_strips[i]->getPixelBuffers(buffers,false)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        virtual CompoundLedStrip* getCompoundLedStrip() { return this;}
+
+    private:
+        // the strip with the LED at index or -1.  LEDs are usually set in order so
+        // the last strip found is checked first
+        int findStrip(uint32_t index) {
+            if (index >= m_offsets[m_count]) { return -1;}
+            if (index >= m_offsets[m_lastStrip] && index < m_offsets[m_lastStrip+1]) {
+                return m_lastStrip;
+            }
+            int low = 0;
+            int high = m_count-1;
+            while(low < high) {
+                int mid = (low+high+1)/2;
+                if (m_offsets[mid] <= index) {
+                    low = mid;
                 } else {
-                   // m_logger->debug("get count strip %d",i);
-                    ledcount += strips[i]->getLEDCount();
+                    high = mid-1;
                 }
             }
-            m_logger->never("getLEDCount()=%d",ledcount);
-            return ledcount;
+            m_lastStrip = low;
+            return low;
         }
 
-        virtual void show() {
-            m_logger->debug("show() %d",count);
-            for(int i=0;i<count;i++) {
-                strips[i]->show();
+        DRLedStrip** m_strips;
+        uint32_t*   m_offsets;
+        int         m_count;
+        int         m_lastStrip;
+};
+
+// maps index i to offset+i*stride.  wrapped maps fold the result back into 0..count-1.
+class IndexMap {
+    public:
+        IndexMap() { set(0,1,0,false);}
+
+        void set(int offset, int stride, int count, bool wrap) {
+            m_offset = offset;
+            m_stride = stride;
+            m_count = count;
+            m_wrap = wrap && count > 0;
+            if (m_wrap) {
+                m_offset = ((offset % count) + count) % count;
             }
         }
 
-        virtual CompoundLedStrip* getCompoundLedStrip() { return this;}
+        uint32_t translate(uint32_t index) const {
+            int tidx = m_offset + m_stride*(int)index;
+            if (m_wrap) {
+                // an index inside the strip needs at most one subtraction
+                if (tidx >= m_count) { tidx -= m_count;}
+                if (tidx < 0 || tidx >= m_count) { tidx = ((tidx % m_count) + m_count) % m_count;}
+            }
+            return tidx;
+        }
 
+        int getCount() const { return m_count;}
     private:
-        DRLedStrip* strips[4]; // max of 4 strips;
-        size_t      count;
+        int m_offset;
+        int m_stride;
+        int m_count;
+        bool m_wrap;
 };
 
 class AlteredStrip : public DRLedStrip {
@@ -291,7 +477,7 @@ class AlteredStrip : public DRLedStrip {
             m_base->setBrightness(brightness);
         }
 
-        virtual void setColor(uint16_t index, const CRGB& color){
+        virtual void setColor(uint32_t index, const CRGB& color){
             m_base->setColor(translateIndex(index),translateColor(color));
         }
 
@@ -300,41 +486,71 @@ class AlteredStrip : public DRLedStrip {
         virtual CompoundLedStrip* getCompoundLedStrip() { return m_base ? m_base->getCompoundLedStrip() : NULL;}
 
     protected:
-        virtual uint16_t translateIndex(uint16_t index) { return index;}
-        virtual uint16_t translateCount(uint16_t count) { return count;}
+        virtual uint32_t translateIndex(uint32_t index) { return index;}
+        virtual int translateCount(int count) { return count;}
         virtual CRGB translateColor(const CRGB& color) { return color;}
     
         DRLedStrip * m_base;
 };
 
+// the base strip must have all of its LEDs when it is wrapped.
+// call updateIndexMap() if the base count changes later.
 class ReverseStrip: public AlteredStrip {
     public:
         ReverseStrip(DRLedStrip* base): AlteredStrip(base) {
             m_logger->debug("create ReverseStrip");
+            updateIndexMap();
+        }
+
+        void updateIndexMap() {
+            int count = getLEDCount();
+            m_indexMap.set(count-1,-1,count,false);
         }
 
         ~ReverseStrip() {
             m_logger->debug("delete ReverseStrip");
         }
 
+        bool getPixelBuffers(PtrList<PixelBuffer*>& buffers, bool reverse) override {
+            return m_base->getPixelBuffers(buffers,!reverse);
+        }
+
     protected:
-        uint16_t translateIndex(uint16_t index) { 
-            return getLEDCount()-index-1;
+        uint32_t translateIndex(uint32_t index) override { 
+            return m_indexMap.translate(index);
         }
+
+        IndexMap m_indexMap;
 };
 
 class RotatedStrip: public AlteredStrip {
     public:
-        RotatedStrip(DRLedStrip* base): AlteredStrip(base) { m_rotationCount = 0;}
+        RotatedStrip(DRLedStrip* base): AlteredStrip(base) { 
+            m_rotationCount = 0;
+            updateIndexMap();
+        }
+
+        void setRotation(int16_t rotation) {
+            if (rotation != m_rotationCount) {
+                m_rotationCount = rotation;
+                updateIndexMap();
+            }
+        }
+
+        int16_t getRotation() const { return m_rotationCount;}
+
+        void updateIndexMap() {
+            m_indexMap.set(m_rotationCount,1,getLEDCount(),true);
+        }
 
     protected:
-        uint16_t translateIndex(int16_t index) { 
-            size_t count =  getLEDCount();
-            return (index + count + m_rotationCount) % count;
+        uint32_t translateIndex(uint32_t index) override { 
+            return m_indexMap.translate(index);
         }
 
     private: 
         int16_t m_rotationCount;
+        IndexMap m_indexMap;
 };
 
 
@@ -347,6 +563,15 @@ class HSLStrip: public AlteredStrip, public IHSLStrip{
             m_hue = NULL;
             m_saturation = NULL;
             m_lightness = NULL;
+            m_shown = NULL;
+            m_showAll = true;
+            m_generation = NULL;
+            m_currentGeneration = 0;
+            m_directOutput = false;
+            m_maxMilliamps = 0;
+            m_milliampsPerChannel = 20;
+            m_powerLimited = false;
+            m_rotation = 0;
             SET_LOGGER(HSLStripLogger);
             m_logger->debug("created HSLStrip with base 0x%04X",base);
         }
@@ -362,9 +587,7 @@ class HSLStrip: public AlteredStrip, public IHSLStrip{
         }
         void setRGB(int index, const CRGB& rgb,HSLOperation op) {
             CHSL hsl = RGBToHSL(rgb);
-            setHue(index,hsl.hue,op);
-            setSaturation(index,hsl.saturation,op);
-            setLightness(index,hsl.lightness,op);
+            setHSL(index,hsl.hue,hsl.saturation,hsl.lightness,op);
         }
 
         void setHue(int index, int16_t hue, HSLOperation op=REPLACE) {
@@ -375,6 +598,7 @@ class HSLStrip: public AlteredStrip, public IHSLStrip{
             if (index == 0) {
                 m_logger->never("hue %d %d",index,hue);
             }
+            touch(index);
             m_hue[index] = clamp(0,359,performOperation(op,m_hue[index],hue));
             if (index == 0) {
                 //m_logger->periodicNever(ERROR_LEVEL,5000,"setHue %d %d %d",index,hue,op);
@@ -386,6 +610,7 @@ class HSLStrip: public AlteredStrip, public IHSLStrip{
                 return;
             } 
             if (saturation<0 || saturation>100) { return;}
+            touch(index);
             m_saturation[index] = clamp(0,100,performOperation(op,m_saturation[index],saturation));
         }
 
@@ -398,74 +623,248 @@ class HSLStrip: public AlteredStrip, public IHSLStrip{
             } 
             
             if (lightness<0 || lightness>100) { return;}
+            touch(index);
             int16_t l = performOperation(op,m_lightness[index],lightness);
             m_logger->never("op %d %d  %d->%d",op,m_lightness[index],lightness,l);
             m_lightness[index] = clamp(0,100,l);
         }
 
+        void setHSL(int index, int16_t hue, int16_t saturation, int16_t lightness, HSLOperation op=REPLACE) {
+            if (index<0 || index>=m_count) {
+                return;
+            }
+            updateHSL(index,hue,saturation,lightness,op);
+        }
+
+        void fillHSL(int index, int count, int16_t hue, int16_t saturation, int16_t lightness, HSLOperation op=REPLACE) {
+            int end = index+count;
+            if (index < 0) { index = 0;}
+            if (end > m_count) { end = m_count;}
+            for(int i=index;i<end;i++) {
+                updateHSL(i,hue,saturation,lightness,op);
+            }
+        }
+
+        void writeHSL(int index, int count, const HSLSpan& values, HSLOperation op=REPLACE) {
+            int end = index+count;
+            int start = index < 0 ? 0 : index;
+            if (end > m_count) { end = m_count;}
+            for(int i=start;i<end;i++) {
+                updateHSL(i,values.getHue(i-index),values.getSaturation(i-index),values.getLightness(i-index),op);
+            }
+        }
+
+        /* Values are not erased.  Each LED has the generation it was last written in and
+         * an LED from an older generation is unset.  The first write to an LED in a new
+         * generation erases its old values.
+         */
         void clear() {
             if (m_base == NULL) {
                 m_logger->warn("HSLStrip does not have a base");
                 return;
             }
             m_logger->debug("Clear HSLStrip");
-            int count = m_base->getLEDCount();
-            m_logger->debug("HSLStrip realloc for %d leds",count);
-            reallocHSLData(count);
-            m_logger->debug("clear HSL values");
-            for(int i=0;i<count;i++) {
-                m_hue[i] = -1;
+            if (m_hue == NULL) {
+                int count = m_base->getLEDCount();
+                m_logger->debug("HSLStrip realloc for %d leds",count);
+                reallocHSLData(count);
+            }
+            m_currentGeneration++;
+            if (m_currentGeneration == 0) {
+                // wrapped.  LEDs may have any old generation so reset them all
+                memset(m_generation,0,sizeof(uint8_t)*m_count);
+                m_currentGeneration = 1;
             }
-            //memset(m_hue,-1,sizeof(int16_t)*count);
-            memset(m_saturation,-1,sizeof(int8_t)*count);
-            memset(m_lightness,-1,sizeof(int8_t)*count);
-            //m_base->clear();
         }
 
+        /* Only LEDs that are different from the last show() are converted to RGB.
+         * If none are different the base strip is not shown.
+         */
+        // the rotation is applied as the LEDs are shown so rotating does not change the drawn values
+        void setRotation(int rotation) { m_rotation = rotation;}
+        int getRotation() const { return m_rotation;}
+
         void show() {
             m_logger->never("show() %d",m_count);
-            for(int idx=0;idx<m_count;idx++) {
-                int hue = m_hue[idx];
-                int sat = m_saturation[idx];
-                int light = m_lightness[idx];
-                if (hue < 0) {
-                    light = 0;
-                }
-                if (false && idx < 20) {
-                    m_logger->never("light: %d",light);
-                }
-                CHSL hsl(clamp(0,360,hue),defaultValue(0,100,sat,100),defaultValue(0,100,light,50));
-                if (idx == 0) {
-                    const CRGB rgb = HSLToRGB(hsl);
-                    m_logger->debug("hsl(%d,%d,%d)->RGB(%d,%d,%d)",hsl.hue,hsl.saturation,hsl.lightness,rgb.red,rgb.green,rgb.blue);
+            int first = m_count;
+            int last = -1;
+            CHSL hsl;
+            // the drawn LED shown at output LED 0
+            int src = m_count > 0 ? ((-m_rotation % m_count) + m_count) % m_count : 0;
+            if (m_powerLimited) {
+                // the buffers were scaled so every LED is written again
+                memset(m_shown,-1,sizeof(uint32_t)*m_count);
+                m_powerLimited = false;
+            }
+            if (m_directOutput) {
+                // LEDs are in the same order as the buffers
+                int idx = 0;
+                m_pixelBuffers.each([&](PixelBuffer* buffer) {
+                    int count = buffer->getCount();
+                    for(int pos=0;pos<count;pos++,idx++) {
+                        if (changed(src,idx,hsl,first,last)) {
+                            buffer->setColor(pos,HSLToRGB(hsl));
+                        }
+                        if (++src == m_count) { src = 0;}
+                    }
+                });
+                limitPower(first,last);
+            } else {
+                for(int idx=0;idx<m_count;idx++) {
+                    if (changed(src,idx,hsl,first,last)) {
+                        m_base->setColor(idx,hsl);
+                    }
+                    if (++src == m_count) { src = 0;}
                 }
-                m_base->setColor(idx,hsl);
             }
-            m_base->show();
+            if (m_showAll) {
+                m_base->show();
+                m_showAll = false;
+            } else if (last >= 0) {
+                m_base->showRange(first,last);
+            }
+        }
+
+        /* Limits the estimated current of all strips to maxMilliamps and each strip
+         * to its own limit.  0 is no limit.  Only direct output is limited.
+         */
+        void setPowerLimit(int maxMilliamps, int milliampsPerChannel) {
+            m_maxMilliamps = maxMilliamps;
+            m_milliampsPerChannel = milliampsPerChannel;
+        }
+
+        // brightness is in the output tables so every LED is converted again
+        void setBrightness(uint16_t brightness) override {
+            m_base->setBrightness(brightness);
+            if (m_shown) {
+                memset(m_shown,-1,sizeof(uint32_t)*m_count);
+            }
+            m_showAll = true;
         }
 
         int getLEDCount() { return m_base->getLEDCount();}
         int getCount() { return m_base->getLEDCount();}
+        // true if show() writes to the driver buffers instead of calling setColor()
+        bool isDirectOutput() const { return m_directOutput;}
         virtual IHSLStrip* getFirstHSLStrip() { return this;}
         virtual CompoundLedStrip* getCompoundLedStrip() { return m_base?m_base->getCompoundLedStrip() : NULL;}
 
     protected:
+        // same checks as setHue(), setSaturation() and setLightness().  index must be valid
+        void updateHSL(int index, int16_t hue, int16_t saturation, int16_t lightness, HSLOperation op) {
+            touch(index);
+            if (hue != HSL_UNSET) {
+                m_hue[index] = clamp(0,359,performOperation(op,m_hue[index],hue));
+            }
+            if (saturation >= 0 && saturation <= 100) {
+                m_saturation[index] = clamp(0,100,performOperation(op,m_saturation[index],saturation));
+            }
+            if (lightness >= 0 && lightness <= 100) {
+                m_lightness[index] = clamp(0,100,performOperation(op,m_lightness[index],lightness));
+            }
+        }
+
+        // scale down the buffers if the frame uses more current than allowed.
+        // the totals are kept as LEDs are written so this only loops when over the limit
+        void limitPower(int& first, int& last) {
+            uint32_t total = 0;
+            m_pixelBuffers.each([&](PixelBuffer* buffer) { total += buffer->getMilliamps(m_milliampsPerChannel);});
+            uint16_t totalScale = 256;
+            if (m_maxMilliamps > 0 && total > (uint32_t)m_maxMilliamps) {
+                totalScale = (uint32_t)m_maxMilliamps*256/total;
+            }
+            m_pixelBuffers.each([&](PixelBuffer* buffer) {
+                uint16_t scale = totalScale;
+                uint32_t milliamps = buffer->getMilliamps(m_milliampsPerChannel);
+                if (buffer->getMaxMilliamps() > 0 && milliamps > (uint32_t)buffer->getMaxMilliamps()) {
+                    uint16_t stripScale = (uint32_t)buffer->getMaxMilliamps()*256/milliamps;
+                    if (stripScale < scale) { scale = stripScale;}
+                }
+                if (scale < 256) {
+                    buffer->scale(scale);
+                    m_powerLimited = true;
+                }
+            });
+            if (m_powerLimited) {
+                m_logger->debug("power limited %d mA",total);
+                first = 0;
+                last = m_count-1;
+            }
+        }
+
+        // sets hsl to the color of drawn LED src.  true (and first/last are updated) if it is different
+        // from output LED idx in the last show()
+        bool changed(int src, int idx, CHSL& hsl, int& first, int& last) {
+            bool set = m_generation[src] == m_currentGeneration;
+            int hue = set ? m_hue[src] : -1;
+            int sat = set ? m_saturation[src] : -1;
+            int light = set ? m_lightness[src] : -1;
+            if (hue < 0) {
+                light = 0;
+            }
+            hsl = CHSL(clamp(0,360,hue),defaultValue(0,100,sat,100),defaultValue(0,100,light,50));
+            uint32_t packed = ((uint32_t)hsl.hue<<16) | (hsl.saturation<<8) | hsl.lightness;
+            if (packed == m_shown[idx]) {
+                return false;
+            }
+            m_shown[idx] = packed;
+            if (idx < first) { first = idx;}
+            last = idx;
+            return true;
+        }
+
+        // unset the LED's values if it has not been written since clear()
+        void touch(int index) {
+            if (m_generation[index] != m_currentGeneration) {
+                m_generation[index] = m_currentGeneration;
+                m_hue[index] = -1;
+                m_saturation[index] = -1;
+                m_lightness[index] = -1;
+            }
+        }
+
+        // write straight to the driver buffers if the base strip has them for every LED
+        void findPixelBuffers() {
+            m_pixelBuffers.clear();
+            m_directOutput = m_base->getPixelBuffers(m_pixelBuffers);
+            int count = 0;
+            m_pixelBuffers.each([&](PixelBuffer* buffer) { count += buffer->getCount();});
+            if (count != m_count) {
+                m_directOutput = false;
+            }
+            m_logger->debug("HSLStrip direct output: %s",m_directOutput ? "yes" : "no");
+        }
+
         void reallocHSLData(int count) {
             if ((count == 0 || count > m_count) && m_hue != NULL) {
                 m_logger->debug("HSLStrip free %d %d",count,m_count);
                 free(m_hue);
                 free(m_saturation);
                 free(m_lightness);
+                free(m_shown);
+                free(m_generation);
                 m_hue = NULL;
+                m_generation = NULL;
                 m_saturation = NULL;
                 m_lightness = NULL;
+                m_shown = NULL;
+                m_pixelBuffers.clear();
+                m_directOutput = false;
             }
             if (count > 0 && m_hue == NULL) {
                 m_logger->debug("HSLStrip malloc %d ",count);
                 m_hue = (int16_t*) malloc(sizeof(int16_t)*count);
                 m_saturation = (int8_t*) malloc(sizeof(int8_t)*count);
                 m_lightness = (int8_t*) malloc(sizeof(int8_t)*count);
+                // nothing has been shown so every LED is different
+                m_shown = (uint32_t*) malloc(sizeof(uint32_t)*count);
+                memset(m_shown,-1,sizeof(uint32_t)*count);
+                m_showAll = true;
+                m_generation = (uint8_t*) malloc(sizeof(uint8_t)*count);
+                memset(m_generation,0,sizeof(uint8_t)*count);
+                m_currentGeneration = 0;
                 m_count = count;
+                findPixelBuffers();
             } else {
                 m_logger->debug("no need to malloc members %d",count);
             }
@@ -514,10 +913,23 @@ class HSLStrip: public AlteredStrip, public IHSLStrip{
         }
 
     private:
-        uint16_t m_count;
+        int m_count;
         int16_t * m_hue;
         int8_t  * m_saturation;
         int8_t  * m_lightness;
+        // packed hue, saturation and lightness of each LED in the last show()
+        uint32_t * m_shown;
+        bool m_showAll;
+        // the clear() each LED was last written after.  0 is never current
+        uint8_t * m_generation;
+        uint8_t m_currentGeneration;
+        PtrList<PixelBuffer*> m_pixelBuffers;
+        bool m_directOutput;
+        int m_maxMilliamps;
+        int m_milliampsPerChannel;
+        // the buffers were scaled down in the last show()
+        bool m_powerLimited;
+        int m_rotation;
         HSLOperation m_op;
 };
 
@@ -537,14 +949,18 @@ class HSLFilter : public DRLedStrip, IHSLStrip {
         void setSaturation(int index, int16_t saturation, HSLOperation op=REPLACE) { if (m_base) { m_base->setSaturation(index,saturation,op);}}
         void setLightness(int index, int16_t lightness, HSLOperation op=REPLACE) { if (m_base) { m_base->setLightness(index,lightness,op);}}
         void setRGB(int index, const CRGB& rgb, HSLOperation op=REPLACE) { if (m_base) { m_base->setRGB(index,rgb,op);}}
+        void setHSL(int index, int16_t hue, int16_t saturation, int16_t lightness, HSLOperation op=REPLACE) { if (m_base) { m_base->setHSL(index,hue,saturation,lightness,op);}}
+        void fillHSL(int index, int count, int16_t hue, int16_t saturation, int16_t lightness, HSLOperation op=REPLACE) { if (m_base) { m_base->fillHSL(index,count,hue,saturation,lightness,op);}}
+        void writeHSL(int index, int count, const HSLSpan& values, HSLOperation op=REPLACE) { if (m_base) { m_base->writeHSL(index,count,values,op);}}
         int getCount() { if (m_base) { return m_base->getCount();} else return 0;}
         int getLEDCount() { if (m_base) { return m_base->getCount();} else return 0;}
         int getStart() { if (m_base) { return m_base->getStart();} else return 0;}
         void clear() { if (m_base) { m_base->clear();}}
         void show() { if (m_base) { m_base->show();}}
+        void setRotation(int rotation) { if (m_base) { m_base->setRotation(rotation);}}
         void setBrightness(uint16_t brightness) { /*filter cannot do this */};
-        void setColor(uint16_t index, CHSL& color) { if (m_base) {m_base->setRGB(index,HSLToRGB(color),REPLACE);}}
-        void setColor(uint16_t index, const CRGB& color) { if (m_base) {m_base->setRGB(index,color,REPLACE);}}
+        void setColor(uint32_t index, CHSL& color) { if (m_base) {m_base->setRGB(index,HSLToRGB(color),REPLACE);}}
+        void setColor(uint32_t index, const CRGB& color) { if (m_base) {m_base->setRGB(index,color,REPLACE);}}
         CompoundLedStrip* getCompoundLedStrip() { return NULL; /* filters can't do this */}
 
     protected:
@@ -3,36 +3,64 @@
 
 #ifdef FAKE_ARDUINO
     #include <chrono>
-    #include <map>
     #include <stddef.h>
+    #include <stdlib.h>
+    #include <malloc.h>
     using namespace std::chrono;
 
     typedef long unsigned int asize_t;
     auto processStartTime = std::chrono::high_resolution_clock::now();
 
 
-    size_t maxHeap=50000;  // assume max of 50000 bytes
+    size_t maxHeap=64*1024*1024;  // large enough that low-memory paths are not taken on the host
     size_t allocatedHeap=0;
-    std::map<void*,size_t> mallocSizeMap;
-
-/*
-    void* operator new(size_t size) {
-        allocatedHeap += size;
-        void* block = malloc(size);
-        mallocSizeMap[block] = size;
-        return block;
-    }
+    size_t allocationCount=0;  // number of malloc/calloc/realloc calls
+
+    // count every allocation so getFreeHeap() changes the same way it does on the device.
+    // malloc/free are replaced (operator new uses malloc) and forward to glibc.
+    extern "C" {
+        void* __libc_malloc(size_t size);
+        void* __libc_calloc(size_t count, size_t size);
+        void* __libc_realloc(void* p, size_t size);
+        void  __libc_free(void* p);
+
+        void* malloc(size_t size) {
+            void* block = __libc_malloc(size);
+            if (block) {
+                allocatedHeap += malloc_usable_size(block);
+                allocationCount++;
+            }
+            return block;
+        }
 
-    void operator delete(void*p) {
-        std::map<void*,size_t>::iterator f = mallocSizeMap.find(p);
-        if (f != mallocSizeMap.end()) {
-            allocatedHeap -= f->second;
-            mallocSizeMap.erase(f);
+        void* calloc(size_t count, size_t size) {
+            void* block = __libc_calloc(count,size);
+            if (block) {
+                allocatedHeap += malloc_usable_size(block);
+                allocationCount++;
+            }
+            return block;
         }
-        free(p);
-    }
-*/
 
+        void* realloc(void* p, size_t size) {
+            size_t oldSize = p ? malloc_usable_size(p) : 0;
+            void* block = __libc_realloc(p,size);
+            if (block) {
+                allocatedHeap += malloc_usable_size(block)-oldSize;
+                allocationCount++;
+            } else if (size == 0) {
+                allocatedHeap -= oldSize;
+            }
+            return block;
+        }
+
+        void free(void* p) {
+            if (p) {
+                allocatedHeap -= malloc_usable_size(p);
+                __libc_free(p);
+            }
+        }
+    }
 
     class EspBoardClass {
         public:
@@ -41,31 +69,39 @@
             }
 
             long getFreeHeap() { 
-                return 0;
+                return (long)maxHeap-(long)allocatedHeap;
             }
 
             long getMaxFreeBlockSize() {
-                return 0;
+                return getFreeHeap();
             }
 
             long getHeapFragmentation() {
                 return 0;
             }
 
+            size_t getAllocationCount() {
+                return allocationCount;
+            }
+
             long currentMsecs() {
                 auto now = std::chrono::high_resolution_clock::now();
-                duration<double> sinceStart = now-processStartTime;
-                long msecs = (long)sinceStart.count();
-                printf("ms: %d",msecs);
-                return msecs;
+                duration<double,std::milli> sinceStart = now-processStartTime;
+                return (long)sinceStart.count();
             }
 
             void delayMsecs(size_t msecs) {
 
             }
 
+            void restart() {
+                exit(0);
+            }
+
     }; 
+    typedef EspBoardClass EspClass;
     EspBoardClass EspBoard;
+    EspClass ESP;
 #else 
     #include <esp.h>
     class EspBoardClass: public EspClass {
@@ -155,6 +155,7 @@ namespace DevRelief {
             TestSuite(const char * name, ILogger* logger,bool logTestMessages=false){
                 m_logTestMessages = logTestMessages;
                 m_name = name;
+                success = true;
                 m_logger = (LOGGER_TYPE*) logger;
             }
             virtual ~TestSuite(){
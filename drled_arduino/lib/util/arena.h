@@ -0,0 +1,225 @@
+#ifndef DR_ARENA_H
+#define DR_ARENA_H
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdint.h>
+
+namespace DevRelief {
+
+/* Arena allocates objects from a few large chunks that are all freed together.
+ * Objects that derive from ArenaObject are allocated from the active arena (see ArenaScope).
+ * deleting an arena object runs its destructor but does not free the memory.
+ * The memory is freed when the arena is released so the heap is not fragmented
+ * by the thousands of small objects in a script.
+ */
+class Arena {
+    public:
+        Arena() {
+            m_firstChunk = NULL;
+            m_chunkSize = 0;
+            // live arenas are linked so delete can tell if memory came from one
+            m_nextArena = s_firstArena;
+            s_firstArena = this;
+        }
+
+        virtual ~Arena() {
+            release();
+            Arena** link = &s_firstArena;
+            while(*link != NULL && *link != this) {
+                link = &(*link)->m_nextArena;
+            }
+            if (*link == this) {
+                *link = m_nextArena;
+            }
+        }
+
+        // the first chunk.  later chunks are needed only if the reserved size is too small
+        void reserve(size_t size) {
+            if (m_chunkSize < size/4) {
+                m_chunkSize = size/4;
+            }
+            if (m_firstChunk == NULL && size > 0) {
+                addChunk(size);
+            }
+        }
+
+        // size of chunks added when the first one is full
+        void setChunkSize(size_t size) { m_chunkSize = size;}
+
+        void* allocate(size_t size) {
+            size = align(size);
+            ArenaChunk* chunk = m_firstChunk;
+            if (chunk == NULL || chunk->used + size > chunk->size) {
+                size_t chunkSize = m_chunkSize;
+                if (chunkSize < ARENA_MIN_CHUNK) {
+                    chunkSize = ARENA_MIN_CHUNK;
+                }
+                chunk = addChunk(size > chunkSize ? size : chunkSize);
+                if (chunk == NULL) {
+                    return NULL;
+                }
+            }
+            void* result = chunk->data()+chunk->used;
+            chunk->used += size;
+            return result;
+        }
+
+        char* allocText(const char * text) {
+            size_t len = text == NULL ? 0 : strlen(text);
+            char* result = (char*)allocate(len+1);
+            if (result) {
+                memcpy(result,text==NULL?"":text,len);
+                result[len] = 0;
+            }
+            return result;
+        }
+
+        bool contains(const void* ptr) const {
+            for(ArenaChunk* chunk=m_firstChunk;chunk!=NULL;chunk=chunk->next) {
+                if ((const uint8_t*)ptr >= chunk->data() && (const uint8_t*)ptr < chunk->data()+chunk->size) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void release() {
+            while(m_firstChunk != NULL) {
+                ArenaChunk* next = m_firstChunk->next;
+                free(m_firstChunk);
+                m_firstChunk = next;
+            }
+        }
+
+        size_t getSize() const {
+            size_t size = 0;
+            for(ArenaChunk* chunk=m_firstChunk;chunk!=NULL;chunk=chunk->next) {
+                size += chunk->size;
+            }
+            return size;
+        }
+
+        size_t getUsed() const {
+            size_t used = 0;
+            for(ArenaChunk* chunk=m_firstChunk;chunk!=NULL;chunk=chunk->next) {
+                used += chunk->used;
+            }
+            return used;
+        }
+
+        int getChunkCount() const {
+            int count = 0;
+            for(ArenaChunk* chunk=m_firstChunk;chunk!=NULL;chunk=chunk->next) {
+                count++;
+            }
+            return count;
+        }
+
+        static Arena* getActive() { return s_active;}
+
+        static bool isArenaMemory(const void* ptr) {
+            for(Arena* arena=s_firstArena;arena!=NULL;arena=arena->m_nextArena) {
+                if (arena->contains(ptr)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // text is copied into the active arena if there is one.
+        static char* copyText(const char * text) {
+            if (s_active != NULL) {
+                char* result = s_active->allocText(text);
+                if (result) {
+                    return result;
+                }
+            }
+            size_t len = text == NULL ? 0 : strlen(text);
+            char* result = (char*)malloc(len+1);
+            memcpy(result,text==NULL?"":text,len);
+            result[len] = 0;
+            return result;
+        }
+
+        static void freeText(const char * text) {
+            if (text != NULL && !isArenaMemory(text)) {
+                free((void*)text);
+            }
+        }
+
+    private:
+        friend class ArenaScope;
+        static const size_t ARENA_MIN_CHUNK = 256;
+
+        struct ArenaChunk {
+            ArenaChunk* next;
+            size_t size;
+            size_t used;
+            uint8_t* data() const { return (uint8_t*)this + align(sizeof(ArenaChunk));}
+        };
+
+        static size_t align(size_t size) {
+            const size_t ALIGN = alignof(max_align_t);
+            return (size + ALIGN - 1) & ~(ALIGN - 1);
+        }
+
+        // new chunks are put first.  allocations only come from the first chunk
+        ArenaChunk* addChunk(size_t size) {
+            size = align(size);
+            ArenaChunk* chunk = (ArenaChunk*)malloc(align(sizeof(ArenaChunk))+size);
+            if (chunk == NULL) {
+                return NULL;
+            }
+            chunk->next = m_firstChunk;
+            chunk->size = size;
+            chunk->used = 0;
+            m_firstChunk = chunk;
+            return chunk;
+        }
+
+        ArenaChunk* m_firstChunk;
+        size_t m_chunkSize;
+        Arena* m_nextArena;
+
+        static Arena* s_active;
+        static Arena* s_firstArena;
+};
+
+Arena* Arena::s_active = NULL;
+Arena* Arena::s_firstArena = NULL;
+
+// makes an arena active until the scope ends
+class ArenaScope {
+    public:
+        ArenaScope(Arena* arena) {
+            m_previous = Arena::s_active;
+            Arena::s_active = arena;
+        }
+
+        ~ArenaScope() {
+            Arena::s_active = m_previous;
+        }
+    private:
+        Arena* m_previous;
+};
+
+// objects of classes that derive from ArenaObject come from the active arena if there is one.
+class ArenaObject {
+    public:
+        static void* operator new(size_t size) {
+            Arena* arena = Arena::getActive();
+            void* ptr = arena ? arena->allocate(size) : NULL;
+            return ptr ? ptr : ::operator new(size);
+        }
+
+        static void operator delete(void* ptr) {
+            if (ptr != NULL && !Arena::isArenaMemory(ptr)) {
+                ::operator delete(ptr);
+            }
+        }
+};
+
+};
+#endif
@@ -66,8 +66,8 @@ public:
             uint8_t* newData = (uint8_t*)malloc(length+1);
             m_logger->info("allocated buffer");
             if (m_data != NULL) {
-                if (length > 0) {
-                    memcpy(newData,m_data,length);
+                if (m_maxLength > 0) {
+                    memcpy(newData,m_data,m_maxLength);
                 }
                 free(m_data);
 
@@ -266,12 +266,17 @@ class DRFormattedString : public DRString{
             va_list args;
             va_start (args,format);
             formatString(format,args);
+            va_end(args);
         }
 
     private:
         void formatString(const char * format, va_list args) {
             char buf[2];
-            int len = vsnprintf(buf,1,format,args)+1;
+            // args are used twice.  the first use needs a copy
+            va_list lenArgs;
+            va_copy(lenArgs,args);
+            int len = vsnprintf(buf,1,format,lenArgs)+1;
+            va_end(lenArgs);
             m_data.get()->ensureLength(len+1);
             vsnprintf(m_data.get()->data(),len,format,args);
         }
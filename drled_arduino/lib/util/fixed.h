@@ -0,0 +1,85 @@
+#ifndef DR_FIXED_H
+#define DR_FIXED_H
+
+// FIXED_POINT 1 does animation and color math with Fixed instead of floating point.
+#ifndef FIXED_POINT
+#define FIXED_POINT 0
+#endif
+
+namespace DevRelief {
+
+/* Q16.16 fixed point number.  The ESP8266 has no FPU so every double operation
+ * is a library call.  Fixed only uses integer operations.
+ * Range is -32768 to 32767.99998 with a resolution of 1/65536.
+ * Values outside of that range overflow so it is only used for percents (0-1)
+ * and small values like colors.
+ */
+class Fixed {
+    public:
+        static const int FRACTION_BITS = 16;
+        static const int32_t ONE = 1<<FRACTION_BITS;
+
+        constexpr Fixed() : m_raw(0) {}
+        constexpr Fixed(int value) : m_raw(value*ONE) {}
+        constexpr Fixed(double value) : m_raw((int32_t)(value*ONE + (value < 0 ? -0.5 : 0.5))) {}
+
+        static constexpr Fixed fromRaw(int32_t raw) { Fixed f; f.m_raw = raw; return f;}
+        // numerator/denominator without converting to floating point.  0 if denominator is 0
+        static Fixed ratio(int64_t numerator, int64_t denominator) {
+            return denominator == 0 ? Fixed() : fromRaw((int32_t)((numerator*ONE)/denominator));
+        }
+
+        int32_t raw() const { return m_raw;}
+        // truncates toward 0 like (int) of a double
+        explicit operator int() const { return m_raw < 0 ? -((-m_raw) >> FRACTION_BITS) : m_raw >> FRACTION_BITS;}
+        explicit operator double() const { return (double)m_raw/ONE;}
+        explicit operator float() const { return (float)m_raw/ONE;}
+
+        Fixed operator-() const { return fromRaw(-m_raw);}
+        Fixed& operator+=(Fixed other) { m_raw += other.m_raw; return *this;}
+        Fixed& operator-=(Fixed other) { m_raw -= other.m_raw; return *this;}
+        Fixed& operator*=(Fixed other) { *this = *this * other; return *this;}
+
+        friend Fixed operator+(Fixed a, Fixed b) { return fromRaw(a.m_raw+b.m_raw);}
+        friend Fixed operator-(Fixed a, Fixed b) { return fromRaw(a.m_raw-b.m_raw);}
+        friend Fixed operator*(Fixed a, Fixed b) { return fromRaw((int32_t)(((int64_t)a.m_raw*b.m_raw) >> FRACTION_BITS));}
+        // division by 0 is 0 like the script functions
+        friend Fixed operator/(Fixed a, Fixed b) { return ratio(a.m_raw,b.m_raw);}
+
+        friend bool operator==(Fixed a, Fixed b) { return a.m_raw == b.m_raw;}
+        friend bool operator!=(Fixed a, Fixed b) { return a.m_raw != b.m_raw;}
+        friend bool operator<(Fixed a, Fixed b) { return a.m_raw < b.m_raw;}
+        friend bool operator<=(Fixed a, Fixed b) { return a.m_raw <= b.m_raw;}
+        friend bool operator>(Fixed a, Fixed b) { return a.m_raw > b.m_raw;}
+        friend bool operator>=(Fixed a, Fixed b) { return a.m_raw >= b.m_raw;}
+    private:
+        int32_t m_raw;
+};
+
+#if FIXED_POINT==1
+typedef Fixed Real;
+#else
+typedef double Real;
+#endif
+
+// numerator/denominator as a T.  Fixed does not use floating point division
+template<typename T> T toReal(int numerator, int denominator) {
+    return T((double)numerator/denominator);
+}
+
+template<typename T> T toReal(double numerator, double denominator) {
+    return T(numerator/denominator);
+}
+
+template<> inline Fixed toReal<Fixed>(int numerator, int denominator) {
+    return Fixed::ratio(numerator,denominator);
+}
+
+// the fraction of numerator and denominator is dropped
+template<> inline Fixed toReal<Fixed>(double numerator, double denominator) {
+    return Fixed::ratio((int64_t)numerator,(int64_t)denominator);
+}
+
+}
+
+#endif
@@ -2,12 +2,14 @@
 #define DR_LIST_H
 
 #include "../log/interface.h"
+#include "./arena.h"
 
 namespace DevRelief {
 
 
+// nodes of lists in a script come from the script's arena
 template<class T>
-struct ListNode
+struct ListNode : public ArenaObject
 {
 	T data;
 	ListNode<T> *next;
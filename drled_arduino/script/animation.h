@@ -4,8 +4,14 @@
 #include "../lib/log/logger.h"
 #include "./script_interface.h"
 
+// number of segments in an ease lookup table
+#ifndef EASE_TABLE_SIZE
+#define EASE_TABLE_SIZE 64
+#endif
+
 namespace DevRelief
 {
+    const int EASE_CURVE_MAX=16;
 
 
     class AnimationRange : public IAnimationRange
@@ -24,7 +30,7 @@ namespace DevRelief
             m_high = high;
             SET_LOGGER(AnimationLogger);
             m_logger->debug("create AnimationRange %f-%f  %s",low,high,unfold?"unfold":"");
-            m_lastPosition = 99999999;
+            m_lastPosition = -1;
             m_lastValue = low;
             m_unfold = unfold;
         }
@@ -39,7 +45,7 @@ namespace DevRelief
         bool unfold() { return m_unfold;}
         void setUnfold(bool unfold) { m_unfold = true;}
 
-        double getValue(double position)
+        double getValue(Real position)
         {
             m_logger->never("AnimationRange::getValue");
             if (position == m_lastPosition) { return m_lastValue;}
@@ -54,7 +60,7 @@ namespace DevRelief
                 return m_high;
             }
             double diff = m_high - m_low;
-            double value = m_low + position * diff;
+            double value = m_low + (double)position * diff;
             m_logger->never("\t %f  %f %f-%f",value,diff,m_low,m_high);
             m_lastPosition = position;
             m_lastValue = value;
@@ -74,7 +80,7 @@ namespace DevRelief
        }
 
     protected:
-        double m_lastPosition;
+        Real m_lastPosition;
         double m_lastValue;
         double m_low;
         double m_high;
@@ -105,12 +111,11 @@ namespace DevRelief
 
         void destroy() override { delete this;}
    
-        double getPercent() override {
+        Real getPercent() override {
             if (getMin() == getMax() || getMin()==getValue()) { return 0;}
             double distance = getMax()-getMin();
             double current = getValue()-getMin();
-            m_logger->never("AnimationDomain %f %f %f",current,distance,current/distance);
-            return current/distance;
+            return toReal<Real>(current,distance);
         }
 
         void setPosition(double pos, double min, double max) {
@@ -405,7 +410,7 @@ namespace DevRelief
         }
 
         void destroy() { delete this;}
-        virtual double calculate(double position) = 0;
+        virtual Real calculate(Real position) = 0;
         void update(IScriptContext* ctx) override { }
 
     protected:
@@ -416,9 +421,8 @@ namespace DevRelief
     {
     public:
         static LinearEase* INSTANCE;
-        double calculate(double position)
+        Real calculate(Real position)
         {
-            m_logger->never("Linear ease %f",position);
             return position;
         }
 
@@ -429,23 +433,149 @@ namespace DevRelief
         }
     };
 
+    // cubic bezier from (0,0) to (1,1) with control points "in" and "out".  multiplies instead of pow()
+    template<typename T> T cubicBezier(T position, T in, T out) {
+        T rest = 1-position;
+        return 3*(rest*rest)*position*in + 3*rest*(position*position)*out + position*position*position;
+    }
+
     LinearEase DefaultEase;
     LinearEase* LinearEase::INSTANCE = &DefaultEase;
+
+    /* An ease curve sampled at EASE_TABLE_SIZE+1 positions from 0 to 1.
+     * calculate() is an index and a linear interpolation so the curve
+     * itself is only evaluated when the table is baked (parse time or
+     * when a script changes the curve's values).
+     * Positions outside of 0-1 extend the first or last segment.
+     */
+    class EaseTable {
+        public:
+            EaseTable() {
+                memset(m_values,0,sizeof(m_values));
+            }
+
+            template<typename F> void bake(F&& curve) {
+                for(int i=0;i<=EASE_TABLE_SIZE;i++) {
+                    m_values[i] = Real((double)curve((double)i/EASE_TABLE_SIZE));
+                }
+            }
+
+            Real calculate(Real position) const {
+                Real scaled = position*EASE_TABLE_SIZE;
+                int index = 0;
+                if (scaled >= EASE_TABLE_SIZE-1) {
+                    index = EASE_TABLE_SIZE-1;
+                } else if (scaled >= 1) {
+                    index = (int)scaled;
+                }
+                return m_values[index] + (m_values[index+1]-m_values[index])*(scaled-index);
+            }
+        private:
+            Real m_values[EASE_TABLE_SIZE+1];
+    };
+
+    typedef double (*EaseCurve)(double position);
+
+    double sineEase(double position) { return (1-cos(PI*position))/2;}
+    double expoEase(double position) {
+        if (position <= 0) { return 0;}
+        if (position >= 1) { return 1;}
+        return position < 0.5 ? pow(2,20*position-10)/2 : (2-pow(2,10-20*position))/2;
+    }
+    double bounceEase(double position) {
+        const double n = 7.5625;
+        const double d = 2.75;
+        if (position < 1/d) {
+            return n*position*position;
+        } else if (position < 2/d) {
+            position -= 1.5/d;
+            return n*position*position + 0.75;
+        } else if (position < 2.5/d) {
+            position -= 2.25/d;
+            return n*position*position + 0.9375;
+        }
+        position -= 2.625/d;
+        return n*position*position + 0.984375;
+    }
+    double elasticEase(double position) {
+        if (position <= 0) { return 0;}
+        if (position >= 1) { return 1;}
+        return pow(2,-10*position)*sin((position*10-0.75)*(2*PI/3))+1;
+    }
+
+    /* Named ease curves a script can use with "ease":"<name>".
+     * Curves are only called when an ease is created so they do not need to be fast.
+     * add() keeps the name pointer so it must be a constant.
+     */
+    class EaseCurves {
+        public:
+            static bool add(const char * name, EaseCurve curve) {
+                if (name == NULL || curve == NULL || indexOf(name) >= 0 || s_count >= EASE_CURVE_MAX) {
+                    return false;
+                }
+                s_names[s_count] = name;
+                s_curves[s_count] = curve;
+                s_count += 1;
+                return true;
+            }
+
+            static int indexOf(const char * name) {
+                if (name == NULL) { return -1;}
+                for(int i=0;i<s_count;i++) {
+                    if (strcmp(s_names[i],name) == 0) {
+                        return i;
+                    }
+                }
+                return -1;
+            }
+
+            static const char * getName(int index) { return s_names[index];}
+            static EaseCurve getCurve(int index) { return s_curves[index];}
+
+        private:
+            static const char * s_names[EASE_CURVE_MAX];
+            static EaseCurve s_curves[EASE_CURVE_MAX];
+            static int s_count;
+    };
+
+    const char * EaseCurves::s_names[EASE_CURVE_MAX] = {"sine","expo","bounce","elastic"};
+    EaseCurve EaseCurves::s_curves[EASE_CURVE_MAX] = {sineEase,expoEase,bounceEase,elasticEase};
+    int EaseCurves::s_count = 4;
+
+    class NamedEase : public AnimationEase
+    {
+    public:
+        NamedEase(int curve) {
+            m_name = EaseCurves::getName(curve);
+            m_table.bake(EaseCurves::getCurve(curve));
+        }
+
+        Real calculate(Real position) override {
+            return m_table.calculate(position);
+        }
+
+        bool toJson(JsonObject* json) const override {
+            json->setString("ease",m_name);
+            return true;
+        }
+    private:
+        const char * m_name;
+        EaseTable m_table;
+    };
+
     class CubicBezierEase : public AnimationEase
     {
     public:
         CubicBezierEase(double in=1, double out=1){
-            m_in = in;
-            m_out = out;
             m_inValue = NULL;
             m_outValue = NULL;
+            setValues(in,out);
         }
 
         CubicBezierEase(IScriptValue* in, IScriptValue* out){
-            m_in = 1;
-            m_out = 1;
             m_inValue = in;
             m_outValue = out;
+            setValues(1,1);
         }
 
         virtual ~CubicBezierEase() {
@@ -454,13 +584,16 @@ namespace DevRelief
         }
 
         void update(IScriptContext* ctx) override {
-            m_in = 1;
-            m_out = 1;
+            double in = 1;
+            double out = 1;
             if (m_inValue) {
-                m_in = (m_inValue->getFloatValue(ctx,1));
+                in = (m_inValue->getFloatValue(ctx,1));
             } 
             if (m_outValue) {
-                m_out = m_outValue->getFloatValue(ctx,0);
+                out = m_outValue->getFloatValue(ctx,0);
+            }
+            if (in != m_in || out != m_out) {
+                setValues(in,out);
             }
          }
 
@@ -484,33 +617,31 @@ namespace DevRelief
         void setValues(double in, double out) {
             m_in = in;
             m_out = out;
+            m_table.bake([&](double position) { return cubicBezier<double>(position,1-in,out);});
         }
-        double calculate(double position)
+
+        Real calculate(Real position)
         {
-            double in = 1-m_in;
-            double out = m_out;
-            double val = 3 * pow(1 - position, 2) * position * in +
-                            3 * (1 - position) * pow(position, 2) * out +
-                            pow(position, 3);
-            return val;
+            return m_table.calculate(position);
         }
         
         bool toJson(JsonObject* json) const override {
             if (m_inValue) {
                 json->set("ease-in",m_inValue->toJson(json->getRoot()));
             } else {
-                json->setInt("ease-in",m_in);
+                json->setInt("ease-in",(int)m_in);
             }
             if (m_outValue) {
                 json->set("ease-out",m_outValue->toJson(json->getRoot()));
             } else {
-                json->setInt("ease-out",m_out);
+                json->setInt("ease-out",(int)m_out);
             }
             return true;
         }
     private:
         double m_in;
         double m_out;
+        EaseTable m_table;
 
         IScriptValue* m_inValue;
         IScriptValue* m_outValue;
@@ -547,6 +678,10 @@ namespace DevRelief
 
         RunState getState() { return m_domain->getState();}
 
+        ValueDependence getDependence() const override {
+            return (m_domain == NULL || m_domain->isTime()) ? VALUE_PER_FRAME : VALUE_PER_LED;
+        }
+
         double getRangeValue(IScriptContext* ctx)
         {
             if (m_domain == NULL || m_range==NULL) {
@@ -559,22 +694,22 @@ namespace DevRelief
             } else if (m_domain->getState() == STATE_COMPLETE) {
                 return m_range->getCompleteValue(ctx);
             }
-            double percent = m_domain->getPercent();
-            double ease = m_ease ? m_ease->calculate(percent) : percent;
+            Real percent = m_domain->getPercent();
+            Real ease = m_ease ? m_ease->calculate(percent) : percent;
 
             if (m_range->unfold()) {
                 if (ease<=0.5) {
                     if (!m_folding) {
                         ease = 0;  // on the switch from unfolding make sure 0 is returned 
                     } else {
-                        ease=ease*2;
+                        ease = ease*2;
                     }
                     m_folding = true;
                 } else {
                     if (m_folding) {
                         ease = 1;// on the switch from folding make sure 1 is returned 
                     } else {
-                        ease= (1-ease)*2;
+                        ease = (1-ease)*2;
                     }
                     m_folding = false;
                 }
@@ -4,12 +4,15 @@
 #include "../lib/log/logger.h"
 #include "../lib/data/data_loader.h"
 #include "../lib/json/parser.h"
+#include "../lib/json/stream_scanner.h"
 #include "./script.h"
 #include "./script_element.h"
 #include "./script_container.h"
 #include "./data_generator.h"
 
 namespace DevRelief {
+    // average arena bytes used by the script objects created from one json element
+    const size_t ARENA_BYTES_PER_JSON_ELEMENT=112;
 
     class ScriptDataLoader : public DataLoader {
         public:
@@ -29,13 +32,19 @@ namespace DevRelief {
             }
 
 
+            // the file is not read into memory at once.  the script properties are parsed first,
+            // then each item of "elements" is parsed and created by itself so only the json of
+            // one element is in memory with the script.
             Script* load(const char * name) {
                 m_logger->debug("load script file: %s",name);
-                Script* script = NULL;
-                loadJsonFile(getPath(name), [&](JsonObject*obj){
-                    script = parseJson(obj);
-                    return true;
-                });
+                DRString path = getPath(name);
+                File file = m_fileSystem.open(path);
+                if (!file.isFile()) {
+                    m_logger->warn("script file not found %s",path.text());
+                    return NULL;
+                }
+                Script* script = loadStream(file);
+                file.close();
                 return script;
             }
 
@@ -80,8 +89,15 @@ namespace DevRelief {
             }
 
             Script* parseJson(JsonObject* scriptJson) {
+                return parseJson(scriptJson,estimateArenaSize(scriptJson));
+            }
+
+            Script* parseJson(JsonObject* scriptJson, size_t arenaSize) {
                 m_logger->debug("parseJson");
                 Script* script = new Script();
+                Arena* arena = script->getArena();
+                arena->reserve(sizeof(ScriptRootContainer)+arenaSize);
+                ArenaScope scope(arena);
                 m_logger->debug("set name");
                 script->setName(scriptJson->getString("name","unnamed"));
                 m_logger->debug("set duration");
@@ -102,7 +118,7 @@ namespace DevRelief {
                     m_logger->debug("Result script: %s",newJson->toString().get());
                     newJson->destroy();
 #endif
-                m_logger->debug("\tparseJson done -> %x",script);
+                m_logger->debug("\tparseJson done -> %x arena %d/%d",script,arena->getUsed(),arena->getSize());
                 return script;
             }
 
@@ -122,6 +138,114 @@ namespace DevRelief {
 
      
 
+            // first pass over the json.  each json element becomes about one script object
+            size_t estimateArenaSize(IJsonElement* json) {
+                if (json == NULL) {
+                    return 0;
+                }
+                size_t size = ARENA_BYTES_PER_JSON_ELEMENT;
+                JsonObject* obj = json->asObject();
+                JsonArray* array = json->asArray();
+                if (obj) {
+                    obj->eachProperty([&](const char * name, IJsonElement* value) {
+                        size += strlen(name)+1 + estimateArenaSize(value);
+                    });
+                } else if (array) {
+                    array->each([&](IJsonElement* value) {
+                        size += estimateArenaSize(value);
+                    });
+                } else if (json->isString()) {
+                    size += strlen(json->asValue()->getString(""))+1;
+                }
+                return size;
+            }
+
+        protected:
+            Script* loadStream(File& file) {
+                // the whole file is scanned first to check it and to size the arena
+                JsonStreamScanner scanner(file);
+                JsonTextStats stats = {0,0};
+                if (!scanner.skipValue(stats)) {
+                    m_logger->error("invalid script json");
+                    return NULL;
+                }
+                JsonParser parser;
+                DRBuffer text;
+                JsonRoot* json = readProperties(scanner,0,text,parser);
+                if (json == NULL || json->asObject() == NULL) {
+                    m_logger->error("invalid script properties");
+                    if (json) { json->destroy();}
+                    return NULL;
+                }
+                Script* script = parseJson(json->asObject(),stats.elementCount*ARENA_BYTES_PER_JSON_ELEMENT+stats.textLength);
+                json->destroy();
+                text.clear();
+                if (!readElements(scanner,0,script->getRootContainer(),parser,script->getArena())) {
+                    m_logger->error("cannot read script elements");
+                    script->destroy();
+                    return NULL;
+                }
+                m_logger->debug("\tloadStream done -> %x arena %d/%d",script,script->getArena()->getUsed(),script->getArena()->getSize());
+                return script;
+            }
+
+            // parses the object at pos without the items of its "elements" array.
+            // the json strings point into text
+            JsonRoot* readProperties(JsonStreamScanner& scanner, size_t pos, DRBuffer& text, JsonParser& parser) {
+                text.setLength(0);
+                text.increaseLength(1)[0] = '{';
+                bool scanned = scanner.scanObject(pos,S_ELEMENTS,[&](const JsonTextRange& range, bool isArray){
+                    if (text.getLength() > 1) {
+                        text.increaseLength(1)[0] = ',';
+                    }
+                    if (isArray) {
+                        // an empty array so the type and children are handled the same as a full one
+                        size_t nameLength = strlen(S_ELEMENTS);
+                        char * elements = text.increaseLength(nameLength+5);
+                        elements[0] = '"';
+                        memcpy(elements+1,S_ELEMENTS,nameLength);
+                        memcpy(elements+1+nameLength,"\":[]",4);
+                        return true;
+                    }
+                    return scanner.readText(range,text.increaseLength(range.length));
+                },[&](const JsonTextRange& range){
+                    return true;
+                });
+                if (!scanned) {
+                    return NULL;
+                }
+                text.increaseLength(1)[0] = '}';
+                return parser.readInPlace((char*)text.text());
+            }
+
+            // creates the children of the object at pos.  each child is created and its json
+            // is destroyed before the children of the child are read
+            bool readElements(JsonStreamScanner& scanner, size_t pos, ScriptContainer* container, JsonParser& parser, Arena* arena) {
+                ScriptElementCreator creator(container);
+                return scanner.scanObject(pos,S_ELEMENTS,[&](const JsonTextRange& range, bool isArray){
+                    return true;
+                },[&](const JsonTextRange& range){
+                    IScriptElement* child = NULL;
+                    {
+                        DRBuffer text;
+                        JsonRoot* json = readProperties(scanner,range.start,text,parser);
+                        if (json == NULL) {
+                            return false;
+                        }
+                        ArenaScope scope(arena);
+                        child = creator.elementFromJson(json->getTopElement(),container);
+                        if (child) {
+                            container->add(child);
+                        }
+                        json->destroy();
+                    }
+                    if (child && child->isContainer()) {
+                        return readElements(scanner,range.start,(ScriptContainer*)child,parser,arena);
+                    }
+                    return true;
+                });
+            }
+
         private:
             DECLARE_LOGGER();
     };
@@ -18,7 +18,7 @@ namespace DevRelief {
 
 
 
-    class PositionProperties {
+    class PositionProperties : public ArenaObject {
         public:
             PositionProperties() {
                 SET_LOGGER(ScriptPositionLogger);
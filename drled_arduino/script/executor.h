@@ -38,11 +38,7 @@ namespace DevRelief {
                 m_ledStrip->clear();
                 m_ledStrip->setBrightness(40);
                 m_logger->debug("Set white level %d.  LED count:%d",level,m_ledStrip->getCount());
-                for(int i=0;i<m_ledStrip->getCount();i++) {
-                    m_ledStrip->setSaturation(i,0);
-                    m_ledStrip->setLightness(i,level);
-                    m_ledStrip->setHue(i,0);
-                }
+                m_ledStrip->fillHSL(0,m_ledStrip->getCount(),0,0,level);
                 m_ledStrip->show();
             }
 
@@ -57,11 +53,7 @@ namespace DevRelief {
                 int saturation = params->getInt("saturation",100);
                 int lightness = params->getInt("lightness",50);
                 m_logger->debug("Set solid %d %d %d %d",m_ledStrip->getCount(),hue,saturation,lightness);
-                for(int i=0;i<m_ledStrip->getCount();i++) {
-                    m_ledStrip->setSaturation(i,saturation);
-                    m_ledStrip->setLightness(i,lightness);
-                    m_ledStrip->setHue(i,hue);
-                }
+                m_ledStrip->fillHSL(0,m_ledStrip->getCount(),hue,saturation,lightness);
                 m_ledStrip->show();
             }
 
@@ -116,7 +108,11 @@ namespace DevRelief {
                 pins.each([&](LedPin* pin) {
                     m_logger->debug("\tadd pin 0x%04X %d %d %d",pin,pin->number,pin->ledCount,pin->reverse);
                     if (pin->number >= 0) {
-                        DRLedStrip * real = new PhyisicalLedStrip(pin->number,pin->ledCount,pin->pixelsPerMeter,pin->pixelType,pin->maxBrightness);
+                        int maxBrightness = pin->maxBrightness < config.getMaxBrightness() ? pin->maxBrightness : config.getMaxBrightness();
+                        PhyisicalLedStrip * real = new PhyisicalLedStrip(pin->number,pin->ledCount,pin->pixelsPerMeter,pin->pixelType,maxBrightness);
+                        real->setOutput(config.getGamma(),pin->redBalance,pin->greenBalance,pin->blueBalance);
+                        real->setBrightness(config.getBrightness());
+                        real->setPowerLimit(pin->maxMilliamps);
                         
                         if (pin->reverse) {
                             auto* reverse = new ReverseStrip(real);
@@ -130,6 +126,7 @@ namespace DevRelief {
                 });
 
                 m_ledStrip = new HSLStrip(compound);
+                m_ledStrip->setPowerLimit(config.getMaxMilliamps(),config.getMilliampsPerChannel());
                 m_logger->info("created HSLStrip");
             }
 
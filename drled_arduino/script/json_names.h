@@ -4,6 +4,7 @@
 namespace DevRelief {
 const char * S_SCRIPT_NAME="name";
 const char * S_FREQUENCY="frequency";
+const char * S_ROTATE="rotate";
 const char * S_ELEMENTS="elements";
 const char * S_TYPE = "type";
 const char * S_RGB = "rgb";
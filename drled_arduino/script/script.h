@@ -4,6 +4,7 @@
 #include "../lib/log/logger.h"
 #include "../lib/led/led_strip.h"
 #include "../lib/util/list.h"
+#include "../lib/util/arena.h"
 #include "../lib/json/json.h"
 #include "./script_interface.h"
 #include "./script_element.h"
@@ -35,6 +36,7 @@ namespace DevRelief
                 m_logger->test("destroy rootcontainer %x",m_rootContainer);
                 m_rootContainer->destroy();
             }
+            // the element tree is gone.  m_arena frees its memory when it is destroyed
             m_logger->test("~Script done");
         }
 
@@ -87,6 +89,9 @@ namespace DevRelief
         }
         int getFrequency() { return m_frequencyMsecs;}
 
+        // the loader allocates the element and value tree from this arena
+        Arena* getArena() { return &m_arena;}
+
         ScriptRootContainer* getRootContainer() { 
             if (m_rootContainer == NULL){
                 m_rootContainer = new ScriptRootContainer();
@@ -96,6 +101,7 @@ namespace DevRelief
     private:
         DECLARE_LOGGER();
         DRString m_name;
+        Arena m_arena;
         ScriptRootContainer* m_rootContainer;
         IHSLStrip* m_realStrip;
         int         m_durationMsecs;
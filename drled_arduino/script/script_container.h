@@ -160,12 +160,20 @@ namespace DevRelief
         public:
             ScriptRootContainer() : ScriptContainer(S_ROOT_CONTAINER,&m_rootContext,&m_rootStrip, &m_rootPosition) {
                 m_logger->info("Created ScriptRootContainer");
+                m_strip = NULL;
+                m_rotateValue = NULL;
+            }
+
+            virtual ~ScriptRootContainer() {
+                if (m_rotateValue) { m_rotateValue->destroy();}
             }
 
-            virtual ~ScriptRootContainer() {}
             void setStrip(IHSLStrip*strip) {
+                m_strip = strip;
                 m_rootStrip.setHSLStrip(strip);
                 m_rootPosition.setRootPosition(0,strip->getCount());
+                // a rotation from the previous script is not kept
+                strip->setRotation(0);
             }
 
             void draw() { 
@@ -175,10 +183,28 @@ namespace DevRelief
                 m_rootPosition.evaluateValues(&m_rootContext);
                 m_rootStrip.updatePosition(&m_rootPosition,&m_rootContext);
                 m_rootContext.beginStep();
+                if (m_rotateValue && m_strip) {
+                    // the whole strip moves when it is shown.  nothing is drawn again
+                    m_strip->setRotation(m_rotateValue->getIntValue(&m_rootContext,0));
+                }
                 drawChildren();
                 m_rootContext.endStep();
             }
 
+            void valuesToJson(JsonObject* json) const override {
+                ScriptContainer::valuesToJson(json);
+                if (m_rotateValue) {
+                    json->set(S_ROTATE,m_rotateValue->toJson(json->getRoot()));
+                }
+            }
+
+            void valuesFromJson(JsonObject* json) override {
+                ScriptContainer::valuesFromJson(json);
+                // fromJson() calls this more than once
+                if (m_rotateValue) { m_rotateValue->destroy();}
+                m_rotateValue = ScriptValue::create(json->getPropertyValue(S_ROTATE));
+            }
+
 
 
             RootContext* getContext() { return &m_rootContext;}
@@ -191,6 +217,8 @@ namespace DevRelief
             RootHSLStrip m_rootStrip;
             RootElementPosition m_rootPosition;
             RootContext m_rootContext;
+            IHSLStrip* m_strip;
+            IScriptValue* m_rotateValue;
     };
 
     class ScriptSegmentContainer : public ScriptContainer {
@@ -233,7 +261,8 @@ namespace DevRelief
                 if (maxDuration>0 && m_startTimeMsecs+maxDuration < millis()) {
                     return true;
                 }
-                IScriptValue *duration = m_valueList->getValue("duration");
+                static ScriptSymbol durationSymbol = ScriptSymbols::intern("duration");
+                IScriptValue *duration = durationSymbol != SYMBOL_NONE ? m_valueList->getSymbolValue(durationSymbol) : m_valueList->getValue("duration");
                 if (duration) {
                     int msecs = duration->getMsecValue(this,0);
                     if (msecs>0 && m_startTimeMsecs+msecs < millis()){
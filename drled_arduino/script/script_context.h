@@ -115,6 +115,14 @@ namespace DevRelief
                 m_valueList->setValue(name,value);
             }
 
+            void setNumberValue(const char * name, double value) override  {
+                m_valueList->setNumber(name,value);
+            }
+
+            void setReferenceValue(const char * name, IScriptValue* target) override  {
+                m_valueList->setReference(name,target);
+            }
+
             IScriptValue* getValue(const char * name)override  {
                 if (m_valueList == NULL) { return NULL; }
                 IScriptValue* val = m_valueList->getValue(name);
@@ -124,10 +132,21 @@ namespace DevRelief
                 return val;
             };
 
+            IScriptValue* getSymbolValue(ScriptSymbol symbol) override {
+                if (m_valueList == NULL) { return NULL; }
+                IScriptValue* val = m_valueList->getSymbolValue(symbol);
+                if (val == NULL && m_parentContext != NULL) {
+                    val = m_parentContext->getSymbolValue(symbol);
+                }
+                return val;
+            }
+
             IScriptValue* getSysValue(const char * name)override  {
                 if (m_valueList == NULL) { return NULL; }
-                DRFormattedString fullName("sys:%s",name);
-                return getValue(fullName.text());
+                // only used when the name is not an interned symbol.  no allocation per lookup
+                char fullName[64];
+                snprintf(fullName,sizeof(fullName),"sys:%s",name);
+                return getValue(fullName);
                 //return m_valueList->getValue(fullName);
             };
 
@@ -146,11 +146,12 @@ namespace DevRelief {
             }
 
             void fromJson(JsonObject* json) override {
-                ScriptElement::fromJson(json);
                 m_logger->never("PositionableElement.fromJson %s %x %x",getType(),this,m_position);
                 LogIndent li;
+                // the position is read first so values are only read once.
+                // reading them twice re-created every child of a container at each level
                 positionFromJson(json);
-                valuesFromJson(json);
+                ScriptElement::fromJson(json);
                 m_logger->never("\tPositionableElement.fromJson done");
             }            
 
@@ -211,7 +212,7 @@ namespace DevRelief {
 
             virtual void draw(IScriptContext*context) override {
                 m_values.each([&](NameValue*nameValue){
-                    context->setValue(nameValue->getName(),new ScriptValueReference(nameValue->getValue()));
+                    context->setReferenceValue(nameValue->getName(),nameValue->getValue());
                 });
             }
 
@@ -234,6 +235,49 @@ namespace DevRelief {
             ScriptValueList m_values;
     };
 
+    // DrawValue holds the value of an IScriptValue for one draw.  values that are the same for every LED
+    // (constants, time animations) are evaluated once in begin().  others are evaluated for each LED.
+    class DrawValue {
+        public:
+            DrawValue() {
+                m_value = NULL;
+                m_perLED = false;
+                m_drawValue = 0;
+            }
+
+            void begin(IScriptValue* value, IScriptContext* ctx, int defaultValue) {
+                m_value = value;
+                m_perLED = value != NULL && value->getDependence(ctx) == VALUE_PER_LED;
+                if (!m_perLED) {
+                    m_drawValue = value ? value->getIntValue(ctx,defaultValue) : defaultValue;
+                }
+            }
+
+            int getIntValue(IScriptContext* ctx, int defaultValue) {
+                return m_perLED ? m_value->getIntValue(ctx,defaultValue) : m_drawValue;
+            }
+
+            // getIntValue() for LEDs first...first+count-1.  the values are whole numbers
+            void getIntValues(IScriptContext* ctx, int first, int count, int defaultValue, double* values) {
+                if (m_perLED) {
+                    m_value->getFloatValues(ctx,first,count,defaultValue,values);
+                    for(int i=0;i<count;i++) {
+                        values[i] = (int)values[i];
+                    }
+                } else {
+                    for(int i=0;i<count;i++) {
+                        values[i] = m_drawValue;
+                    }
+                }
+            }
+
+            bool isPerLED() const { return m_perLED;}
+        private:
+            IScriptValue* m_value;
+            bool m_perLED;
+            int m_drawValue;
+    };
+
     class ScriptLEDElement : public PositionableElement{
         public:
             ScriptLEDElement(const char* type) : PositionableElement(type,&m_elementPosition) {
@@ -251,6 +295,13 @@ namespace DevRelief {
                 //m_elementPosition.evaluateValues(context);
                 m_logger->never("create DrawStrip");
                 DrawStrip strip(context,parentStrip,&m_elementPosition);
+                if (!strip.begin()) {
+                    return;
+                }
+                beginDraw(context);
+                if (drawStrip(context,strip)) {
+                    return;
+                }
                 m_logger->never("\titerate LEDs");
                 strip.eachLED([&](IHSLStripLED& led) {
                     DrawLED* dl = (DrawLED*)&led;
@@ -273,7 +324,11 @@ namespace DevRelief {
             }
 
         protected:
-            
+            // called before the first LED is drawn.  evaluate values that do not change for each LED
+            virtual void beginDraw(IScriptContext* context) {}
+            // draw the LEDs with span writes instead of one LED at a time.
+            // return false to draw each LED with drawLED()
+            virtual bool drawStrip(IScriptContext* context, DrawStrip& strip) { return false;}
             virtual void drawLED(IHSLStripLED& led)=0;
             ScriptElementPosition m_elementPosition;
             
@@ -306,27 +361,75 @@ namespace DevRelief {
                 m_lightness = val;
             }
         protected:
-            void drawLED(IHSLStripLED& led) override {
-                if (m_hue) {
-                    int hue = m_hue->getIntValue(led.getContext(),-1);
-                    if (hue != -1) {
-                        m_logger->never("drawLED %d %d",led.getIndex(),hue);
-                        led.setHue(adjustHue(hue));
-                    }
+            void beginDraw(IScriptContext* context) override {
+                m_drawHue.begin(m_hue,context,-1);
+                m_drawLightness.begin(m_lightness,context,-1);
+                m_drawSaturation.begin(m_saturation,context,-1);
+            }
+
+            bool drawStrip(IScriptContext* context, DrawStrip& strip) override {
+                if (m_drawHue.isPerLED() || m_drawLightness.isPerLED() || m_drawSaturation.isPerLED()) {
+                    return drawChunks(context,strip);
                 }
-                
-                if (m_lightness) {
-                    int lightness = m_lightness->getIntValue(led.getContext(),-1);
-                    if (lightness != -1) {
-                        led.setLightness(adjustLightness( lightness));
-                    }
+                int hue = m_hue ? m_drawHue.getIntValue(NULL,-1) : -1;
+                int lightness = m_lightness ? m_drawLightness.getIntValue(NULL,-1) : -1;
+                int saturation = m_saturation ? m_drawSaturation.getIntValue(NULL,-1) : -1;
+                if (hue != -1 || lightness != -1 || saturation != -1) {
+                    strip.fillLEDs(hue != -1 ? adjustHue(hue) : HSL_UNSET,
+                        saturation != -1 ? adjustSaturation(saturation) : HSL_UNSET,
+                        lightness != -1 ? adjustLightness(lightness) : HSL_UNSET);
                 }
-                if (m_saturation) {
-                    int saturation = m_saturation->getIntValue(led.getContext(),-1);
-                    if (saturation != -1) {
-                        led.setSaturation(adjustSaturation( saturation));
+                return true;
+            }
+
+            // evaluate the values for SCRIPT_VALUE_CHUNK LEDs at a time and write each chunk as a span.
+            // a negative length (reversed) strip is drawn one LED at a time
+            bool drawChunks(IScriptContext* context, DrawStrip& strip) {
+                int length = strip.getLength();
+                if (length < 0) {
+                    return false;
+                }
+                double values[SCRIPT_VALUE_CHUNK];
+                int16_t hue[SCRIPT_VALUE_CHUNK];
+                int16_t saturation[SCRIPT_VALUE_CHUNK];
+                int16_t lightness[SCRIPT_VALUE_CHUNK];
+                HSLSpan span(m_hue ? hue : NULL,m_saturation ? saturation : NULL,m_lightness ? lightness : NULL);
+                for(int first=0;first<length;first+=SCRIPT_VALUE_CHUNK) {
+                    int count = length-first < SCRIPT_VALUE_CHUNK ? length-first : SCRIPT_VALUE_CHUNK;
+                    if (m_hue) {
+                        m_drawHue.getIntValues(context,first,count,-1,values);
+                        for(int i=0;i<count;i++) {
+                            int h = values[i];
+                            hue[i] = h != -1 ? adjustHue(h) : HSL_UNSET;
+                        }
+                    }
+                    if (m_lightness) {
+                        m_drawLightness.getIntValues(context,first,count,-1,values);
+                        for(int i=0;i<count;i++) {
+                            int l = values[i];
+                            lightness[i] = l != -1 ? adjustLightness(l) : HSL_UNSET;
+                        }
                     }
+                    if (m_saturation) {
+                        m_drawSaturation.getIntValues(context,first,count,-1,values);
+                        for(int i=0;i<count;i++) {
+                            int s = values[i];
+                            saturation[i] = s != -1 ? adjustSaturation(s) : HSL_UNSET;
+                        }
+                    }
+                    strip.writeLEDs(first,count,span);
                 }
+                return true;
+            }
+
+            void drawLED(IHSLStripLED& led) override {
+                int hue = m_hue ? m_drawHue.getIntValue(led.getContext(),-1) : -1;
+                int lightness = m_lightness ? m_drawLightness.getIntValue(led.getContext(),-1) : -1;
+                int saturation = m_saturation ? m_drawSaturation.getIntValue(led.getContext(),-1) : -1;
+                m_logger->never("drawLED %d %d",led.getIndex(),hue);
+                led.setHSL(hue != -1 ? adjustHue(hue) : HSL_UNSET,
+                    saturation != -1 ? adjustSaturation(saturation) : HSL_UNSET,
+                    lightness != -1 ? adjustLightness(lightness) : HSL_UNSET);
             }
 
             virtual int adjustHue(int hue) { return hue;}
@@ -359,6 +462,9 @@ namespace DevRelief {
             IScriptValue* m_hue;
             IScriptValue* m_saturation;
             IScriptValue* m_lightness;
+            DrawValue m_drawHue;
+            DrawValue m_drawSaturation;
+            DrawValue m_drawLightness;
     };
 
     class RainbowHSLElement : public HSLElement {
@@ -382,7 +488,7 @@ namespace DevRelief {
         protected:
             virtual int adjustHue(int hue) { 
                 if (hue <0) { return hue;}
-                return m_map.calculate(1.0*hue/360.0)*360.0;
+                return (double)m_map.calculate(toReal<Real>(hue,360))*360.0;
             }
 
         private:
@@ -417,19 +523,25 @@ namespace DevRelief {
                 m_blue = val;
             }
         protected:
+            void beginDraw(IScriptContext* context) override {
+                m_drawRed.begin(m_red,context,0);
+                m_drawGreen.begin(m_green,context,0);
+                m_drawBlue.begin(m_blue,context,0);
+            }
+
             void drawLED(IHSLStripLED& led) override {
                 int red = 0;
                 int green = 0;
                 int blue = 0;
                 if (m_red) {
-                    red = m_red->getIntValue(led.getContext(),0);
+                    red = m_drawRed.getIntValue(led.getContext(),0);
                 }
                 
                 if (m_blue) {
-                    blue = m_blue->getIntValue(led.getContext(),0);
+                    blue = m_drawBlue.getIntValue(led.getContext(),0);
                 }
                 if (m_green) {
-                    green = m_green->getIntValue(led.getContext(),0);
+                    green = m_drawGreen.getIntValue(led.getContext(),0);
                 }
                 if (red != 0 || blue != 0 || green != 0) {
                     CRGB rgb(red,green,blue);
@@ -465,6 +577,9 @@ namespace DevRelief {
             IScriptValue* m_red;
             IScriptValue* m_green;
             IScriptValue* m_blue;
+            DrawValue m_drawRed;
+            DrawValue m_drawGreen;
+            DrawValue m_drawBlue;
     };
 
 }
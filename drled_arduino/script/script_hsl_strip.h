@@ -21,7 +21,9 @@ namespace DevRelief{
                 m_flowIndex = 0;
                 m_position = NULL;
                 m_reverse = false;
-
+                m_mapTarget = NULL;
+                m_mapOffset = 0;
+                m_mapStride = 1;
             }
 
             virtual ~ScriptHSLStrip() {
@@ -43,11 +45,13 @@ namespace DevRelief{
             void setParent(IScriptHSLStrip* parent) override { 
                 if (parent == this) { return;}
                 m_parent = parent;
+                m_mapTarget = NULL;
             }
             IScriptHSLStrip* getParent() const override {  return m_parent;}
 
             void setHue(int16_t hue,int index, HSLOperation op) override {
                 m_logger->debug("ScriptHSLStrip.setHue(%d,%d) strip=%x parent=%x op=%d",hue,index,this,m_parent,translateOp(op));
+                if (isMapped(index,1)) { m_mapTarget->setHue(hue,mapIndex(index),op); return;}
                 if (!isPositionValid(index)) { 
                     m_logger->debug("Invalid index %d, %d",index,m_length);
                     return;
@@ -57,21 +61,75 @@ namespace DevRelief{
             }
 
             void setSaturation(int16_t saturation,int index, HSLOperation op) override {
+                if (isMapped(index,1)) { m_mapTarget->setSaturation(saturation,mapIndex(index),op); return;}
                 if (!isPositionValid(index)) { return;}            
                 m_logger->never("ScriptHSLStrip.setSaturation op=%d",translateOp(op)); 
                 m_parent->setSaturation(saturation,translateIndex(index),translateOp(op));
             }
 
             void setLightness(int16_t lightness,int index, HSLOperation op) override {
+                if (isMapped(index,1)) { m_mapTarget->setLightness(lightness,mapIndex(index),op); return;}
                 if (!isPositionValid(index)) { return;}             
                 
                 m_parent->setLightness(lightness,translateIndex(index),translateOp(op));
             }
 
             void setRGB(const CRGB& rgb,int index, HSLOperation op) override {
-                
+                if (isMapped(index,1)) { m_mapTarget->setRGB(rgb,mapIndex(index),op); return;}
                 m_parent->setRGB(rgb,translateIndex(index),translateOp(op));
             }  
+
+            void setHSL(int16_t hue,int16_t saturation,int16_t lightness,int index, HSLOperation op) override {
+                if (isMapped(index,1)) { m_mapTarget->setHSL(hue,saturation,lightness,mapIndex(index),op); return;}
+                if (!isPositionValid(index)) { return;}
+                parentSetHSL(hue,saturation,lightness,translateIndex(index),translateOp(op));
+            }
+
+            void fillHSL(int16_t hue,int16_t saturation,int16_t lightness,int index, int count, HSLOperation op) override {
+                if (isMapped(index,count)) {
+                    int first = mapIndex(m_mapStride < 0 ? index+count-1 : index);
+                    m_mapTarget->fillHSL(hue,saturation,lightness,first,count,op);
+                    return;
+                }
+                if (count <= 0 || !isPositionValid(index)) { return;}
+                HSLOperation top = translateOp(op);
+                eachSpan(index,count,
+                    [&](int led) { parentSetHSL(hue,saturation,lightness,translateIndex(led),top);},
+                    [&](int first, int spanCount) {
+                        // a reversed span is still contiguous in the parent.  it starts at the last LED
+                        int parentIndex = translateIndex(m_reverse ? first+spanCount-1 : first);
+                        parentFillHSL(hue,saturation,lightness,parentIndex,spanCount,top);
+                    });
+            }
+
+            void writeHSL(const HSLSpan& values,int index, int count, HSLOperation op) override {
+                if (isMapped(index,count)) {
+                    if (m_mapStride > 0) {
+                        m_mapTarget->writeHSL(values,mapIndex(index),count,op);
+                    } else {
+                        for(int i=0;i<count;i++) {
+                            m_mapTarget->setHSL(values.getHue(i),values.getSaturation(i),values.getLightness(i),mapIndex(index+i),op);
+                        }
+                    }
+                    return;
+                }
+                if (count <= 0 || !isPositionValid(index)) { return;}
+                HSLOperation top = translateOp(op);
+                auto writeLED = [&](int led) {
+                    int i = led-index;
+                    parentSetHSL(values.getHue(i),values.getSaturation(i),values.getLightness(i),translateIndex(led),top);
+                };
+                eachSpan(index,count,writeLED,
+                    [&](int first, int spanCount) {
+                        if (m_reverse) {
+                            for(int led=first;led<first+spanCount;led++) {
+                                writeLED(led);
+                            }
+                        } else {
+                            parentWriteHSL(values.from(first-index),translateIndex(first),spanCount,top);
+                        }
+                    });
+            }
   
             int getFlowIndex() const { 
                 return m_flowIndex;
@@ -152,6 +210,7 @@ namespace DevRelief{
                     auto pin = config->getPin(strip);
                     if (pin == 0) {
                         m_length = 0;
+                        m_mapTarget = NULL;
                         m_logger->error(LM("pin not found %d"),strip);
                         return;
                     }
@@ -183,7 +242,15 @@ namespace DevRelief{
 
                     m_parent->setFlowIndex(m_offset+m_length);
                 }
-                
+                updateIndexMap();
+            }
+
+            bool getIndexMap(int first, int count, IScriptHSLStrip*& target, int& offset, int& stride) override {
+                if (!isMapped(first,count)) { return false;}
+                target = m_mapTarget;
+                offset = m_mapOffset;
+                stride = m_mapStride;
+                return true;
             }
 
             virtual bool isPositionValid(int index) {
@@ -209,7 +276,7 @@ namespace DevRelief{
             }
 
             virtual int oldtranslateIndex(int origIndex){
-               int index = reverse ? (m_length-origIndex-1) : origIndex;
+               int index = m_reverse ? (m_length-origIndex-1) : origIndex;
                 int tidx = index+m_offset;
                 if (m_overflow == OVERFLOW_WRAP) {
                     if (index<m_offset) { tidx = m_length- (index%m_length);}
@@ -230,6 +297,74 @@ namespace DevRelief{
                 return op;
             }
 
+            // strips that write more than one parent LED or change the operation return false.
+            // LEDs are never mapped through them
+            virtual bool canMapIndexes() { return true;}
+
+            // LEDs 0..m_length-1 are contiguous in the parent.  if the parent passes that range on to another
+            // strip, the two maps are combined so writes skip the strips between this one and the target
+            void updateIndexMap() {
+                m_mapTarget = NULL;
+                if (!canMapIndexes() || m_parent == NULL || m_length <= 0) { return;}
+                int first = m_reverse ? m_offset+m_length-1 : m_offset;
+                int stride = m_reverse ? -1 : 1;
+                IScriptHSLStrip* target = NULL;
+                int offset = 0;
+                int parentStride = 1;
+                if (m_parent->getIndexMap(m_offset,m_length,target,offset,parentStride)) {
+                    m_mapTarget = target;
+                    m_mapOffset = offset + parentStride*first;
+                    m_mapStride = parentStride*stride;
+                } else {
+                    m_mapTarget = m_parent;
+                    m_mapOffset = first;
+                    m_mapStride = stride;
+                }
+            }
+
+            bool isMapped(int index, int count) const {
+                return m_mapTarget != NULL && count > 0 && index >= 0 && index+count <= m_length;
+            }
+
+            int mapIndex(int index) const { return m_mapOffset + m_mapStride*index;}
+
+            // LEDs inside the strip are one span that is contiguous in the parent.  LEDs outside the strip
+            // are clipped or wrapped by translateIndex() so they are passed to setLED() one at a time.
+            void eachSpan(int index, int count, auto&& setLED, auto&& setSpan) {
+                int end = index+count;
+                int first = index;
+                int last = end;
+                if (m_overflow != OVERFLOW_ALLOW) {
+                    if (first < 0) { first = 0;}
+                    if (last > m_length) { last = m_length;}
+                }
+                for(int led=index;led<first && led<end;led++) {
+                    setLED(led);
+                }
+                if (last > first) {
+                    setSpan(first,last-first);
+                } else {
+                    last = first;
+                }
+                for(int led=last;led<end;led++) {
+                    setLED(led);
+                }
+            }
+
+            // strips that write to more than one parent LED (mirror, copy, ...) override these.
+            // the index is already translated to the parent.
+            virtual void parentSetHSL(int16_t hue,int16_t saturation,int16_t lightness,int parentIndex, HSLOperation op) {
+                m_parent->setHSL(hue,saturation,lightness,parentIndex,op);
+            }
+
+            virtual void parentFillHSL(int16_t hue,int16_t saturation,int16_t lightness,int parentIndex, int count, HSLOperation op) {
+                m_parent->fillHSL(hue,saturation,lightness,parentIndex,count,op);
+            }
+
+            virtual void parentWriteHSL(const HSLSpan& values,int parentIndex, int count, HSLOperation op) {
+                m_parent->writeHSL(values,parentIndex,count,op);
+            }
+
             IScriptHSLStrip* m_parent;
             IElementPosition* m_position;
             int m_parentLength;
@@ -237,6 +372,10 @@ namespace DevRelief{
             int m_offset;
             int m_flowIndex;
             bool m_reverse;
+            // set by updateIndexMap().  NULL if writes go through translateIndex()
+            IScriptHSLStrip* m_mapTarget;
+            int m_mapOffset;
+            int m_mapStride;
 
             PositionUnit m_unit;
             PositionOverflow m_overflow;
@@ -340,6 +479,18 @@ namespace DevRelief{
 
 
         protected:
+            void parentSetHSL(int16_t hue,int16_t saturation,int16_t lightness,int parentIndex, HSLOperation op) override {
+                m_base->setHSL(parentIndex,hue,saturation,lightness,op);
+            }
+
+            void parentFillHSL(int16_t hue,int16_t saturation,int16_t lightness,int parentIndex, int count, HSLOperation op) override {
+                m_base->fillHSL(parentIndex,count,hue,saturation,lightness,op);
+            }
+
+            void parentWriteHSL(const HSLSpan& values,int parentIndex, int count, HSLOperation op) override {
+                m_base->writeHSL(parentIndex,count,values,op);
+            }
+
             virtual HSLOperation translateOp(HSLOperation op) {
                 m_logger->never("root translate %x op %d %d",m_position,op,m_position->getHSLOperation());
                 HSLOperation pop = m_position ? m_position->getHSLOperation() : ADD;
@@ -349,6 +500,8 @@ namespace DevRelief{
                 return op;
             }
 
+            bool canMapIndexes() override { return false;}
+
             IHSLStrip* m_base;
     };
 
@@ -391,6 +544,9 @@ namespace DevRelief{
             void setRGB(const CRGB& rgb)  override {
                 m_strip->setRGB(rgb,m_index,m_operation);
             }
+            void setHSL(int hue, int saturation, int lightness) override {
+                m_strip->setHSL(hue,saturation,lightness,m_index,m_operation);
+            }
 
             IScriptContext* getContext() const override { return m_context;}
             IScriptHSLStrip* getStrip() const override { return m_strip;}
@@ -416,6 +572,34 @@ namespace DevRelief{
 
             }
 
+            // set the animation position to the first LED.  returns false if there are no LEDs to draw
+            bool begin() {
+                if (m_length == 0) {
+                    return false;
+                }
+                PositionDomain* domain = m_context->getAnimationPositionDomain();
+                if (domain) { 
+                    domain->setPosition(0,0,m_length-1);
+                    domain->setPos(0);
+                }
+                return true;
+            }
+
+            // draw every LED with the same value in one call
+            void fillLEDs(int16_t hue, int16_t saturation, int16_t lightness) {
+                HSLOperation op = m_position->getHSLOperation();
+                if (m_length < 0) {
+                    fillHSL(hue,saturation,lightness,m_length+1,-m_length,op);
+                } else {
+                    fillHSL(hue,saturation,lightness,0,m_length,op);
+                }
+            }
+
+            // write LEDs first...first+count-1.  only used for positive lengths
+            void writeLEDs(int first, int count, const HSLSpan& values) {
+                writeHSL(values,first,count,m_position->getHSLOperation());
+            }
+
             void eachLED(auto&& drawer) {
                 
                 HSLOperation op = m_position->getHSLOperation();
@@ -2,6 +2,9 @@
 #define SCRIPT_STATUS_H
 
 #include "../lib/led/led_strip.h"
+#include "../lib/util/fixed.h"
+#include "../lib/util/arena.h"
+#include "./script_symbols.h"
 
 namespace DevRelief{
     typedef enum PositionUnit
@@ -35,6 +38,17 @@ namespace DevRelief{
         STATE_COMPLETE
     };
 
+    // what a value's result can change with.  ordered so the larger value wins when combined
+    typedef enum ValueDependence {
+        VALUE_CONSTANT=0,   // same result every time
+        VALUE_PER_FRAME=1,  // may change each step (time, step number) but is the same for every LED
+        VALUE_PER_LED=2     // may change for each LED (LED position, random)
+    };
+
+    // the most LEDs passed to IScriptValue::getFloatValues() in one call.
+    // callers keep the buffers on the stack so this is small.
+    const int SCRIPT_VALUE_CHUNK=16;
+
     class IScriptContext;
     class IScriptValue;
     class IScriptHSLStrip;
@@ -43,6 +57,7 @@ namespace DevRelief{
     class ScriptValueList;
     class ScriptContainer;
     class ScriptTimerValue;
+    class ScriptProgram;
 
     class UnitValue {
         public:
@@ -102,10 +117,10 @@ namespace DevRelief{
             virtual long getMsecsSincePrev()=0;
     };
 
-    class IAnimationDomain {
+    class IAnimationDomain : public ArenaObject {
         public:
             virtual void destroy()=0;
-            virtual double getPercent()=0; // return current posion as % from min to max (0..1)
+            virtual Real getPercent()=0; // return current posion as % from min to max (0..1)
             virtual double getMin() const = 0;
             virtual double getMax() const= 0;
             virtual double getValue() const= 0;
@@ -116,13 +131,13 @@ namespace DevRelief{
             virtual bool toJson(JsonObject* json) const=0;
     };
     
-    class IAnimationRange {
+    class IAnimationRange : public ArenaObject {
         public:
             virtual void destroy()=0;
             
             virtual double getMinValue()=0;
             virtual double getMaxValue()=0;
-            virtual double getValue(double percent)=0;
+            virtual double getValue(Real percent)=0;
             virtual double getDistance()=0; // distance from min to max (max-min+1)
             virtual bool unfold()=0;
             virtual void update(IScriptContext* ctx)=0;
@@ -131,21 +146,23 @@ namespace DevRelief{
             virtual bool toJson(JsonObject* json) const=0;
     };
 
-    class IAnimationEase {
+    class IAnimationEase : public ArenaObject {
         public:
             virtual void destroy()=0;
-            virtual double calculate(double position) = 0;
+            virtual Real calculate(Real position) = 0;
             virtual void update(IScriptContext* ctx)=0;
             virtual bool toJson(JsonObject* json) const=0;
     };
 
-    class IValueAnimator {
+    class IValueAnimator : public ArenaObject {
     public:
         virtual void destroy()=0;
         virtual double getRangeValue(IScriptContext* ctx)=0;
         virtual IValueAnimator* clone(IScriptContext* ctx)=0;
         virtual void update(IScriptContext* ctx)=0;
         virtual bool toJson(JsonObject* json) const=0;
+        // VALUE_PER_LED if the animation position is the LED
+        virtual ValueDependence getDependence() const=0;
     };
 
     class IHSLStripLED {
@@ -154,6 +171,8 @@ namespace DevRelief{
             virtual void setSaturation(int saturation)=0;
             virtual void setLightness(int lightnext)=0;
             virtual void setRGB(const CRGB& rgb)=0;
+            // values that are HSL_UNSET are not changed
+            virtual void setHSL(int hue, int saturation, int lightness)=0;
 
             virtual IScriptContext* getContext() const=0;
             virtual IScriptHSLStrip* getStrip() const = 0;
@@ -175,9 +194,18 @@ namespace DevRelief{
             virtual void setSaturation(int16_t saturation, int index, HSLOperation op)=0;
             virtual void setLightness(int16_t lightness, int index, HSLOperation op)=0;
             virtual void setRGB(const CRGB& rgb, int index, HSLOperation op)=0;
+            // one call for all 3 values.  values that are HSL_UNSET are not changed
+            virtual void setHSL(int16_t hue, int16_t saturation, int16_t lightness, int index, HSLOperation op)=0;
+            // span writes pass a range of LEDs to the parent in one call where the LEDs are contiguous in the parent
+            virtual void fillHSL(int16_t hue, int16_t saturation, int16_t lightness, int index, int count, HSLOperation op)=0;
+            virtual void writeHSL(const HSLSpan& values, int index, int count, HSLOperation op)=0;
 
             virtual void updatePosition(IElementPosition * pos, IScriptContext* context)=0;
 
+            // if LEDs first..first+count-1 only move to LEDs of another strip, LED i is target LED offset+i*stride.
+            // returns false when the strip changes the values or writes more than one LED
+            virtual bool getIndexMap(int first, int count, IScriptHSLStrip*& target, int& offset, int& stride)=0;
+
             virtual IScriptHSLStrip* getParent() const=0;
             virtual void setParent(IScriptHSLStrip* parent)=0;
 
@@ -198,9 +226,14 @@ namespace DevRelief{
             virtual PositionDomain* getAnimationPositionDomain()=0;
 
             virtual void setValue(const char* name, IScriptValue* value)=0;
+            // set every frame.  reuse the value from the last frame instead of allocating
+            virtual void setNumberValue(const char* name, double value)=0;
+            virtual void setReferenceValue(const char* name, IScriptValue* target)=0;
             virtual void setSysValue(const char * name, IScriptValue* value)=0;
             virtual IScriptValue* getValue(const char * name)=0;
             virtual IScriptValue* getSysValue(const char * name)=0;
+            // faster lookup of a value by its interned name
+            virtual IScriptValue* getSymbolValue(ScriptSymbol symbol)=0;
 
             virtual void setStrip(IScriptHSLStrip*strip)=0;
             virtual IScriptHSLStrip* getStrip() const = 0;
@@ -218,7 +251,7 @@ namespace DevRelief{
 
     };
 
-    class IScriptValue
+    class IScriptValue : public ArenaObject
     {
     public:
         virtual void destroy() =0; // cannot delete pure virtual interfaces. they must all implement destroy
@@ -259,6 +292,18 @@ namespace DevRelief{
         virtual DRString toString() = 0;
 
         virtual IScriptValue* clone() const = 0;
+
+        // append instructions to a ScriptProgram that leave this value on the program's stack.
+        // values that are not compiled should use program->loadValue(this)
+        virtual void compile(ScriptProgram* program)=0;
+
+        // used by elements to evaluate values once per draw instead of once per LED.
+        // variables are resolved in the context so ctx may change the result.
+        virtual ValueDependence getDependence(IScriptContext* ctx)=0;
+
+        // values[i] = the value at LED position first+i for i < count.  count is at most SCRIPT_VALUE_CHUNK.
+        // the context's position domain is left at an unspecified LED.
+        virtual void getFloatValues(IScriptContext* ctx, int first, int count, double defaultValue, double* values)=0;
     };
 
     class IScriptTimer : public IScriptValue {
@@ -266,20 +311,23 @@ namespace DevRelief{
             virtual ScriptStatus updateStatus(IScriptContext* context)=0;
     };
 
-    class IScriptValueProvider
+    class IScriptValueProvider : public ArenaObject
     {
     public:
         virtual void destroy() =0; // cannot delete pure virtual interfaces. they must all implement destroy
         virtual bool hasValue(const char *name) = 0;
         virtual IScriptValue *getValue(const char *name) = 0;
+        virtual IScriptValue *getSymbolValue(ScriptSymbol symbol) = 0;
         virtual void setValue(const char *name, IScriptValue*val)=0;
+        virtual void setNumber(const char *name, double val)=0;
+        virtual void setReference(const char *name, IScriptValue* target)=0;
         virtual void initialize(ScriptValueList* source, IScriptContext* context)=0;
         virtual void clear()=0;
     };
 
 
 
-    class IScriptElement {
+    class IScriptElement : public ArenaObject {
         public:
             virtual void destroy()=0;
             virtual bool isContainer() const =0;
@@ -316,7 +364,7 @@ namespace DevRelief{
             DECLARE_LOGGER();
     };
 
-    class ScriptPatternElement
+    class ScriptPatternElement : public ArenaObject
     {
     public:
         ScriptPatternElement(IScriptValue* repeatCount, PositionUnit repeatUnit, IScriptValue* value)
@@ -335,6 +383,11 @@ namespace DevRelief{
 
         int getPixelCount() const { return m_pixelCount;}
         IScriptValue* getValue() const { return m_value;}
+        ValueDependence getDependence(IScriptContext* ctx) const {
+            ValueDependence value = m_value ? m_value->getDependence(ctx) : VALUE_CONSTANT;
+            ValueDependence count = m_repeatCount ? m_repeatCount->getDependence(ctx) : VALUE_CONSTANT;
+            return value > count ? value : count;
+        }
         virtual void destroy() { delete this;}
 
         IJsonElement* toJson(JsonRoot* jsonRoot) { 
@@ -342,7 +395,7 @@ namespace DevRelief{
             if (m_repeatCount) {
                 obj->set("count",m_repeatCount->toJson(jsonRoot));
             }
-            obj->set("value",m_value ? m_value->toJson(jsonRoot) : new JsonNull(jsonRoot));
+            obj->set("value",m_value ? m_value->toJson(jsonRoot) : jsonRoot->createNull());
             return obj;
         }
         DRString toString() {
@@ -0,0 +1,491 @@
+#ifndef DRSCRIPT_PROGRAM_H
+#define DRSCRIPT_PROGRAM_H
+
+#include "../lib/log/logger.h"
+#include "./script_interface.h"
+
+namespace DevRelief
+{
+    typedef enum ScriptFunctionOp {
+        FUNC_UNKNOWN=0,
+        FUNC_RAND,
+        FUNC_ADD,
+        FUNC_SUBTRACT,
+        FUNC_MULTIPLY,
+        FUNC_DIVIDE,
+        FUNC_MOD,
+        FUNC_MIN,
+        FUNC_MAX,
+        FUNC_RAND_OF,
+        FUNC_SEQUENCE
+    };
+
+    struct ScriptFunctionName {
+        const char * name;
+        ScriptFunctionOp op;
+    };
+
+    const ScriptFunctionName functionNames[] = {
+        {"rand",FUNC_RAND},
+        {"add",FUNC_ADD},{"+",FUNC_ADD},
+        {"subtract",FUNC_SUBTRACT},{"sub",FUNC_SUBTRACT},{"-",FUNC_SUBTRACT},
+        {"multiply",FUNC_MULTIPLY},{"*",FUNC_MULTIPLY},{"mult",FUNC_MULTIPLY},
+        {"divide",FUNC_DIVIDE},{"div",FUNC_DIVIDE},{"/",FUNC_DIVIDE},
+        {"mod",FUNC_MOD},{"%",FUNC_MOD},
+        {"min",FUNC_MIN},
+        {"max",FUNC_MAX},
+        {"randOf",FUNC_RAND_OF},
+        {"seq",FUNC_SEQUENCE},{"sequence",FUNC_SEQUENCE},
+        {NULL,FUNC_UNKNOWN}
+    };
+
+    ScriptFunctionOp functionNameToOp(const char * name) {
+        if (name == NULL || name[0] == 0) { return FUNC_UNKNOWN;}
+        for(int i=0;functionNames[i].name != NULL;i++) {
+            if (strcmp(name,functionNames[i].name) == 0) {
+                return functionNames[i].op;
+            }
+        }
+        return FUNC_UNKNOWN;
+    }
+
+    typedef enum ScriptOpCode {
+        OP_END=0,
+        OP_PUSH_CONST,      // push m_constants[index]
+        OP_PUSH_DEFAULT,    // push the current default value
+        OP_DUP_INT,         // push (int) of the top of the stack
+        OP_LOAD_VALUE,      // push m_values[index]->getFloatValue(ctx,default)
+        OP_DEFAULT_CONST,   // make m_constants[index] the default for the following values
+        OP_DEFAULT_TOP_INT, // make (int) of the top of the stack the default
+        OP_DEFAULT_POP,     // restore the previous default
+        OP_TRUNC,           // top = (int)top
+        OP_NEG,
+        OP_ADD,
+        OP_SUB,
+        OP_MUL,
+        OP_DIV,
+        OP_MOD,
+        OP_MIN,
+        OP_MAX,
+        OP_RAND,            // pop high, low.  push random(low,high+1)
+        OP_SEQUENCE,        // pop step, end, start.  m_state[index] is the current value
+        OP_RAND_OF,         // jump to one of the "index" OP_JUMP instructions that follow
+        OP_JUMP             // continue at instruction "index"
+    };
+
+    struct ScriptInstruction {
+        uint8_t op;
+        uint16_t index;
+    };
+
+    // values deeper than this are not compiled.  the stacks are on the C stack
+    // while a program runs so this is kept small for the ESP8266.
+    const int SCRIPT_PROGRAM_MAX_STACK=16;
+
+    /* ScriptProgram is a function expression (["+",["*","var(a)",2],1])
+     * compiled into a flat list of instructions for a small stack machine.
+     * Numbers and nested functions are compiled into the program.  Any other value
+     * (variables, patterns, ...) is kept in a table and loaded by one virtual call.
+     * The program does not own the values in the table.
+     *
+     * Programs without random values or sequences can also run for a range of LEDs
+     * at once (runRange).  Each stack entry is then a lane of SCRIPT_VALUE_CHUNK values.
+     */
+    class ScriptProgram {
+        public:
+            ScriptProgram() {
+                SET_LOGGER(ScriptValueLogger);
+                m_code = NULL;
+                m_codeCount = 0;
+                m_codeSize = 0;
+                m_constants = NULL;
+                m_constantCount = 0;
+                m_constantSize = 0;
+                m_values = NULL;
+                m_valueCount = 0;
+                m_valueSize = 0;
+                m_state = NULL;
+                m_stateCount = 0;
+                m_stateSize = 0;
+                m_depth = 0;
+                m_maxDepth = 0;
+                m_defaultDepth = 0;
+                m_maxDefaultDepth = 0;
+                m_vectorizable = false;
+                m_lanes = NULL;
+                m_runningRange = false;
+            }
+
+            virtual ~ScriptProgram() {
+                free(m_code);
+                free(m_constants);
+                free(m_values);
+                free(m_state);
+                free(m_lanes);
+            }
+
+            void destroy() { delete this;}
+
+            // program is only usable if the stacks fit
+            bool isValid() const {
+                return m_depth == 1 && m_maxDepth <= SCRIPT_PROGRAM_MAX_STACK && m_maxDefaultDepth < SCRIPT_PROGRAM_MAX_STACK;
+            }
+
+            int getInstructionCount() const { return m_codeCount;}
+
+            // true if every LED in a range can be evaluated by the same instructions.
+            // a recursive variable can load this program while it is running a range.  the lanes are in use then
+            bool canRunRange() const { return m_vectorizable && !m_runningRange;}
+
+            // emit functions are used by IScriptValue::compile()
+            void pushConstant(double value) {
+                add(OP_PUSH_CONST,addConstant(value),1);
+            }
+
+            void pushDefault() { add(OP_PUSH_DEFAULT,0,1);}
+            void dupInt() { add(OP_DUP_INT,0,1);}
+
+            void loadValue(IScriptValue* value) {
+                if (m_valueCount == m_valueSize) {
+                    m_valueSize = m_valueSize*2+4;
+                    m_values = (IScriptValue**)realloc(m_values,m_valueSize*sizeof(IScriptValue*));
+                }
+                m_values[m_valueCount] = value;
+                add(OP_LOAD_VALUE,m_valueCount++,1);
+            }
+
+            void beginDefault(double value) {
+                add(OP_DEFAULT_CONST,addConstant(value),0);
+                pushDefaultDepth();
+            }
+
+            void beginDefaultFromTopInt() {
+                add(OP_DEFAULT_TOP_INT,0,0);
+                pushDefaultDepth();
+            }
+
+            void endDefault() {
+                add(OP_DEFAULT_POP,0,0);
+                m_defaultDepth--;
+            }
+
+            // operator on the top "popCount" values.  the result replaces them
+            void operation(ScriptOpCode op, int popCount) {
+                add(op,0,1-popCount);
+            }
+
+            void sequence(int popCount) {
+                if (m_stateCount == m_stateSize) {
+                    m_stateSize = m_stateSize*2+2;
+                    m_state = (double*)realloc(m_state,m_stateSize*sizeof(double));
+                }
+                m_state[m_stateCount] = -1;
+                add(OP_SEQUENCE,m_stateCount++,1-popCount);
+            }
+
+            // randOf: emits the jump table.  the caller compiles each choice
+            // between beginChoice() and endChoice()
+            int beginChoices(int count) {
+                add(OP_RAND_OF,count,0);
+                int table = m_codeCount;
+                for(int i=0;i<count;i++) {
+                    add(OP_JUMP,0,0);
+                }
+                return table;
+            }
+
+            void beginChoice(int table, int choice) {
+                m_code[table+choice].index = m_codeCount;
+            }
+
+            // each choice leaves one value on the stack but only one choice runs
+            int endChoice(int choice) {
+                int jump = m_codeCount;
+                add(OP_JUMP,0,0);
+                if (choice > 0) {
+                    m_depth--;
+                }
+                return jump;
+            }
+
+            void setJumpTarget(int jump) {
+                m_code[jump].index = m_codeCount;
+            }
+
+            void end() {
+                add(OP_END,0,0);
+                // free unused space
+                m_code = (ScriptInstruction*)realloc(m_code,m_codeCount*sizeof(ScriptInstruction));
+                m_codeSize = m_codeCount;
+                // random values and sequences must be evaluated in LED order
+                m_vectorizable = true;
+                for(int i=0;i<m_codeCount;i++) {
+                    uint8_t op = m_code[i].op;
+                    if (op == OP_RAND || op == OP_SEQUENCE || op == OP_RAND_OF || op == OP_JUMP || op == OP_DEFAULT_TOP_INT) {
+                        m_vectorizable = false;
+                    }
+                }
+            }
+
+            double run(IScriptContext* ctx, double defaultValue) {
+                double stack[SCRIPT_PROGRAM_MAX_STACK];
+                double defaults[SCRIPT_PROGRAM_MAX_STACK];
+                int top = -1;
+                int defaultTop = 0;
+                defaults[0] = defaultValue;
+                const ScriptInstruction* code = m_code;
+                int pc = 0;
+                while(true) {
+                    const ScriptInstruction& inst = code[pc++];
+                    switch(inst.op) {
+                        case OP_END:
+                            return stack[top];
+                        case OP_PUSH_CONST:
+                            stack[++top] = m_constants[inst.index];
+                            break;
+                        case OP_PUSH_DEFAULT:
+                            stack[++top] = defaults[defaultTop];
+                            break;
+                        case OP_DUP_INT:
+                            stack[top+1] = (int)stack[top];
+                            top++;
+                            break;
+                        case OP_LOAD_VALUE:
+                            stack[++top] = m_values[inst.index]->getFloatValue(ctx,defaults[defaultTop]);
+                            break;
+                        case OP_DEFAULT_CONST:
+                            defaults[++defaultTop] = m_constants[inst.index];
+                            break;
+                        case OP_DEFAULT_TOP_INT:
+                            defaults[++defaultTop] = (int)stack[top];
+                            break;
+                        case OP_DEFAULT_POP:
+                            defaultTop--;
+                            break;
+                        case OP_TRUNC:
+                            stack[top] = (int)stack[top];
+                            break;
+                        case OP_NEG:
+                            stack[top] = -stack[top];
+                            break;
+                        case OP_ADD:
+                            top--;
+                            stack[top] = stack[top] + stack[top+1];
+                            break;
+                        case OP_SUB:
+                            top--;
+                            stack[top] = stack[top] - stack[top+1];
+                            break;
+                        case OP_MUL:
+                            top--;
+                            stack[top] = stack[top] * stack[top+1];
+                            break;
+                        case OP_DIV:
+                            top--;
+                            stack[top] = stack[top+1] == 0 ? 0 : stack[top] / stack[top+1];
+                            break;
+                        case OP_MOD:
+                            top--;
+                            stack[top] = (int)stack[top+1] == 0 ? 0 : (double)((int)stack[top] % (int)stack[top+1]);
+                            break;
+                        case OP_MIN:
+                            top--;
+                            stack[top] = stack[top] < stack[top+1] ? stack[top] : stack[top+1];
+                            break;
+                        case OP_MAX:
+                            top--;
+                            stack[top] = stack[top] > stack[top+1] ? stack[top] : stack[top+1];
+                            break;
+                        case OP_RAND: {
+                            top--;
+                            int low = stack[top];
+                            int high = stack[top+1];
+                            if (high == low) {
+                                low = 0;
+                            }
+                            if (high < low) {
+                                int t = low;
+                                low = high;
+                                high = t;
+                            }
+                            stack[top] = random(low,high+1);
+                            break;
+                        }
+                        case OP_SEQUENCE: {
+                            top -= 2;
+                            int start = stack[top];
+                            int end = stack[top+1];
+                            int step = stack[top+2];
+                            double& state = m_state[inst.index];
+                            if (state < start) {
+                                state = start;
+                            } else {
+                                state += step;
+                            }
+                            if (state > end) {
+                                state = start;
+                            }
+                            stack[top] = state;
+                            break;
+                        }
+                        case OP_RAND_OF:
+                            pc += random(inst.index);
+                            break;
+                        case OP_JUMP:
+                            pc = inst.index;
+                            break;
+                        default:
+                            m_logger->error("unknown program instruction %d",inst.op);
+                            return defaultValue;
+                    }
+                }
+            }
+
+            // results[i] = run() at LED position first+i.  count is at most SCRIPT_VALUE_CHUNK.
+            // only valid if canRunRange()
+            void runRange(IScriptContext* ctx, int first, int count, double defaultValue, double* results) {
+                if (m_lanes == NULL) {
+                    // allocated on first use.  most programs never run for a range
+                    m_lanes = (double*)malloc(m_maxDepth*SCRIPT_VALUE_CHUNK*sizeof(double));
+                }
+                double defaults[SCRIPT_PROGRAM_MAX_STACK];
+                int defaultTop = 0;
+                defaults[0] = defaultValue;
+                double* top = m_lanes-SCRIPT_VALUE_CHUNK;
+                const ScriptInstruction* code = m_code;
+                int pc = 0;
+                m_runningRange = true;
+                while(true) {
+                    const ScriptInstruction& inst = code[pc++];
+                    double* b = top;
+                    switch(inst.op) {
+                        case OP_END:
+                            memcpy(results,top,count*sizeof(double));
+                            m_runningRange = false;
+                            return;
+                        case OP_PUSH_CONST:
+                            top += SCRIPT_VALUE_CHUNK;
+                            for(int i=0;i<count;i++) { top[i] = m_constants[inst.index];}
+                            break;
+                        case OP_PUSH_DEFAULT:
+                            top += SCRIPT_VALUE_CHUNK;
+                            for(int i=0;i<count;i++) { top[i] = defaults[defaultTop];}
+                            break;
+                        case OP_DUP_INT:
+                            top += SCRIPT_VALUE_CHUNK;
+                            for(int i=0;i<count;i++) { top[i] = (int)b[i];}
+                            break;
+                        case OP_LOAD_VALUE:
+                            top += SCRIPT_VALUE_CHUNK;
+                            m_values[inst.index]->getFloatValues(ctx,first,count,defaults[defaultTop],top);
+                            break;
+                        case OP_DEFAULT_CONST:
+                            defaults[++defaultTop] = m_constants[inst.index];
+                            break;
+                        case OP_DEFAULT_POP:
+                            defaultTop--;
+                            break;
+                        case OP_TRUNC:
+                            for(int i=0;i<count;i++) { top[i] = (int)top[i];}
+                            break;
+                        case OP_NEG:
+                            for(int i=0;i<count;i++) { top[i] = -top[i];}
+                            break;
+                        case OP_ADD:
+                            top -= SCRIPT_VALUE_CHUNK;
+                            for(int i=0;i<count;i++) { top[i] = top[i] + b[i];}
+                            break;
+                        case OP_SUB:
+                            top -= SCRIPT_VALUE_CHUNK;
+                            for(int i=0;i<count;i++) { top[i] = top[i] - b[i];}
+                            break;
+                        case OP_MUL:
+                            top -= SCRIPT_VALUE_CHUNK;
+                            for(int i=0;i<count;i++) { top[i] = top[i] * b[i];}
+                            break;
+                        case OP_DIV:
+                            top -= SCRIPT_VALUE_CHUNK;
+                            for(int i=0;i<count;i++) { top[i] = b[i] == 0 ? 0 : top[i] / b[i];}
+                            break;
+                        case OP_MOD:
+                            top -= SCRIPT_VALUE_CHUNK;
+                            for(int i=0;i<count;i++) { top[i] = (int)b[i] == 0 ? 0 : (double)((int)top[i] % (int)b[i]);}
+                            break;
+                        case OP_MIN:
+                            top -= SCRIPT_VALUE_CHUNK;
+                            for(int i=0;i<count;i++) { top[i] = top[i] < b[i] ? top[i] : b[i];}
+                            break;
+                        case OP_MAX:
+                            top -= SCRIPT_VALUE_CHUNK;
+                            for(int i=0;i<count;i++) { top[i] = top[i] > b[i] ? top[i] : b[i];}
+                            break;
+                        default:
+                            m_logger->error("instruction %d cannot run for a range",inst.op);
+                            for(int i=0;i<count;i++) { results[i] = defaultValue;}
+                            m_runningRange = false;
+                            return;
+                    }
+                }
+            }
+
+        protected:
+            void add(ScriptOpCode op, int index, int stackChange) {
+                if (m_codeCount == m_codeSize) {
+                    m_codeSize = m_codeSize*2+8;
+                    m_code = (ScriptInstruction*)realloc(m_code,m_codeSize*sizeof(ScriptInstruction));
+                }
+                m_code[m_codeCount].op = op;
+                m_code[m_codeCount].index = index;
+                m_codeCount++;
+                m_depth += stackChange;
+                if (m_depth > m_maxDepth) {
+                    m_maxDepth = m_depth;
+                }
+            }
+
+            int addConstant(double value) {
+                for(int i=0;i<m_constantCount;i++) {
+                    if (m_constants[i] == value) {
+                        return i;
+                    }
+                }
+                if (m_constantCount == m_constantSize) {
+                    m_constantSize = m_constantSize*2+4;
+                    m_constants = (double*)realloc(m_constants,m_constantSize*sizeof(double));
+                }
+                m_constants[m_constantCount] = value;
+                return m_constantCount++;
+            }
+
+            void pushDefaultDepth() {
+                m_defaultDepth++;
+                if (m_defaultDepth > m_maxDefaultDepth) {
+                    m_maxDefaultDepth = m_defaultDepth;
+                }
+            }
+
+            ScriptInstruction* m_code;
+            int m_codeCount;
+            int m_codeSize;
+            double* m_constants;
+            int m_constantCount;
+            int m_constantSize;
+            IScriptValue** m_values;
+            int m_valueCount;
+            int m_valueSize;
+            double* m_state;
+            int m_stateCount;
+            int m_stateSize;
+
+            // stack depths tracked while compiling
+            int m_depth;
+            int m_maxDepth;
+            int m_defaultDepth;
+            int m_maxDefaultDepth;
+            bool m_vectorizable;
+            double* m_lanes;
+            bool m_runningRange;
+            DECLARE_LOGGER();
+    };
+}
+#endif
@@ -0,0 +1,73 @@
+#ifndef DRSCRIPT_SYMBOLS_H
+#define DRSCRIPT_SYMBOLS_H
+
+#include "../lib/log/logger.h"
+
+namespace DevRelief
+{
+    typedef int16_t ScriptSymbol;
+    const ScriptSymbol SYMBOL_NONE=-1;
+
+    const int SCRIPT_SYMBOL_MAX=64;
+    const int SCRIPT_SYMBOL_TEXT_SIZE=768;
+
+    /* Variable names are interned when a script is loaded.  Values are stored and
+     * found by their symbol (a small index) instead of comparing names.
+     * The table is static (not heap) and only grows.  The same names are
+     * used by most scripts so it does not need to be cleared when scripts change.
+     * If the table is full, names are not interned and lookups use the name.
+     */
+    class ScriptSymbols {
+        public:
+            static ScriptSymbol intern(const char * name) {
+                ScriptSymbol symbol = find(name);
+                if (symbol != SYMBOL_NONE || name == NULL || name[0] == 0) {
+                    return symbol;
+                }
+                size_t len = strlen(name)+1;
+                if (s_count >= SCRIPT_SYMBOL_MAX || s_textLength+len > SCRIPT_SYMBOL_TEXT_SIZE) {
+                    if (!s_fullLogged) {
+                        DECLARE_LOGGER();
+                        SET_LOGGER(ScriptLogger);
+                        m_logger->warn("symbol table is full.  %s is not interned",name);
+                        s_fullLogged = true;
+                    }
+                    return SYMBOL_NONE;
+                }
+                memcpy(s_text+s_textLength,name,len);
+                s_names[s_count] = s_textLength;
+                s_textLength += len;
+                return s_count++;
+            }
+
+            static ScriptSymbol find(const char * name) {
+                if (name == NULL) { return SYMBOL_NONE;}
+                for(int i=0;i<s_count;i++) {
+                    if (strcmp(s_text+s_names[i],name) == 0) {
+                        return i;
+                    }
+                }
+                return SYMBOL_NONE;
+            }
+
+            static const char * getName(ScriptSymbol symbol) {
+                return (symbol >= 0 && symbol < s_count) ? s_text+s_names[symbol] : NULL;
+            }
+
+            static int getCount() { return s_count;}
+
+        private:
+            static char s_text[SCRIPT_SYMBOL_TEXT_SIZE];
+            static uint16_t s_names[SCRIPT_SYMBOL_MAX];
+            static int s_count;
+            static size_t s_textLength;
+            static bool s_fullLogged;
+    };
+
+    char ScriptSymbols::s_text[SCRIPT_SYMBOL_TEXT_SIZE];
+    uint16_t ScriptSymbols::s_names[SCRIPT_SYMBOL_MAX];
+    int ScriptSymbols::s_count=0;
+    size_t ScriptSymbols::s_textLength=0;
+    bool ScriptSymbols::s_fullLogged=false;
+}
+#endif
@@ -14,7 +14,7 @@
 namespace DevRelief
 {
 
-    class TimerState {
+    class TimerState : public ArenaObject {
         public:
             static TimerState* copy(const TimerState* other) {
                 if (other == NULL) { return NULL;}
@@ -96,7 +96,7 @@ namespace DevRelief
             void evaluate(IScriptContext* context, ScriptValueList& list) {
                 list.each([&](NameValue* value) {
                     double val = value->getValue()->getFloatValue(context,0);
-                    context->setValue(value->getName(),new ScriptNumberValue(val));
+                    context->setNumberValue(value->getName(),val);
                 });
             }
             ScriptStatus m_status;
@@ -148,6 +148,11 @@ namespace DevRelief
 
             void destroy() override { delete this;}
             bool isTimer(IScriptContext* cmd) const override { return true;}
+            void compile(ScriptProgram* program) override { program->loadValue(this);}
+            ValueDependence getDependence(IScriptContext* ctx) override { return VALUE_PER_FRAME;}
+            void getFloatValues(IScriptContext* ctx, int first, int count, double defaultValue, double* values) override {
+                ScriptValue::fillFloatValues(getFloatValue(ctx,defaultValue),count,values);
+            }
             
             double getFloatValue(IScriptContext* ctx,double defaultValue)  {
                 return m_runState?m_runState->getDuration() : defaultValue;
@@ -201,7 +206,7 @@ namespace DevRelief
 
             IJsonElement* toJson(JsonRoot* jsonRoot) override {
                 m_logger->error("toJson() not implemented");
-                JsonObject* obj = new JsonObject(jsonRoot);
+                JsonObject* obj = jsonRoot->createObject();
                 obj->setString("toJson","not implemented");
                 return obj;
             }
@@ -10,17 +10,14 @@
 #include "../lib/led/color.h"
 #include "./script_interface.h"
 #include "./script_value.h"
+#include "./script_program.h"
+#include "./script_symbols.h"
 #include "./animation.h"
 
 
 namespace DevRelief
 {
-
-    const char * functionNames[] = {
-        "rand","add","+","subtract","sub","-","multiply","*","mult",
-        "divide","div","/","mod","%","min","max","randOf","seq","sequence",
-        NULL
-    };
+    class ScriptNumberValue;
 
     // ScriptValueReference is a pointer to another ScriptValue 
     // the pointer can be deleted while the real value remains
@@ -33,6 +30,8 @@ namespace DevRelief
             virtual ~ScriptValueReference() { /* do not delete m_reference*/}
             void destroy() override { delete this;}
 
+            IScriptValue* getReference() const { return m_reference;}
+
             int getIntValue(IScriptContext* ctx,  int defaultValue)  { return m_reference->getIntValue(ctx,defaultValue);}
             double getFloatValue(IScriptContext* ctx,  double defaultValue)  { return m_reference->getFloatValue(ctx,defaultValue);} 
             bool getBoolValue(IScriptContext* ctx,  bool defaultValue)  { return m_reference->getBoolValue(ctx,defaultValue); }
@@ -64,6 +63,11 @@ namespace DevRelief
             DRString stringify() { return m_reference->stringify();}
 
             IScriptValue* clone()const override { return m_reference->clone();}
+            void compile(ScriptProgram* program) override { program->loadValue(this);}
+            ValueDependence getDependence(IScriptContext* ctx) override { return m_reference->getDependence(ctx);}
+            void getFloatValues(IScriptContext* ctx, int first, int count, double defaultValue, double* values) override {
+                m_reference->getFloatValues(ctx,first,count,defaultValue,values);
+            }
         private:
             IScriptValue* m_reference;
     };
@@ -120,7 +124,7 @@ namespace DevRelief
             
             IJsonElement* toJson(JsonRoot* jsonRoot) override {
                 m_logger->error("toJson() not implemented");
-                JsonObject* obj = new JsonObject(jsonRoot);
+                JsonObject* obj = jsonRoot->createObject();
                 obj->setString("toJson","not implemented");
                 return obj;
             }
@@ -136,6 +140,29 @@ namespace DevRelief
             DRString stringify() override { return "";}
 
             ScriptStatus getStatus(IScriptContext* context, ScriptStatus defaultValue=SCRIPT_RUNNING) const override { return defaultValue;}
+
+            void compile(ScriptProgram* program) override { program->loadValue(this);}
+            // unknown values are evaluated for every LED
+            ValueDependence getDependence(IScriptContext* ctx) override { return VALUE_PER_LED;}
+
+            void getFloatValues(IScriptContext* ctx, int first, int count, double defaultValue, double* values) override {
+                getEachFloatValue(this,ctx,first,count,defaultValue,values);
+            }
+
+            // getFloatValues() for values that can only be evaluated one LED at a time
+            static void getEachFloatValue(IScriptValue* value, IScriptContext* ctx, int first, int count, double defaultValue, double* values) {
+                PositionDomain* domain = ctx ? ctx->getAnimationPositionDomain() : NULL;
+                for(int i=0;i<count;i++) {
+                    if (domain) { domain->setPos(first+i);}
+                    values[i] = value->getFloatValue(ctx,defaultValue);
+                }
+            }
+
+            static void fillFloatValues(double value, int count, double* values) {
+                for(int i=0;i<count;i++) {
+                    values[i] = value;
+                }
+            }
         protected:
 
       
@@ -144,24 +171,28 @@ namespace DevRelief
 
  
   
-    class NameValue
+    class NameValue : public ArenaObject
     {
     public:
         NameValue(const char *name, IScriptValue *value)
         {
-            m_name = Util::allocText(name);
+            m_name = Arena::copyText(name);
             m_value = value;
+            m_symbol = ScriptSymbols::intern(name);
+            m_number = NULL;
+            m_reference = NULL;
         }
 
         virtual ~NameValue()
         {
-            Util::freeText(m_name);
-            m_value->destroy();
+            Arena::freeText(m_name);
+            if (m_value) { m_value->destroy();}
         }
 
         virtual void destroy() { delete this;}
 
         const char *getName() { return m_name; }
+        ScriptSymbol getSymbol() { return m_symbol; }
         IScriptValue *getValue() { return m_value; }
 
         void replaceValue(IScriptValue* newValue) {
@@ -170,13 +201,31 @@ namespace DevRelief
             }
             if (m_value) { m_value->destroy();}
             m_value = newValue;
+            m_number = NULL;
+            m_reference = NULL;
+        }
+
+        // values set every frame reuse the value this NameValue created last time
+        // so a step does not allocate.
+        void setNumber(double value);
+
+        void setReference(IScriptValue* target) {
+            if (m_reference != NULL && m_reference->getReference() == target) {
+                return;
+            }
+            ScriptValueReference* reference = new ScriptValueReference(target);
+            replaceValue(reference);
+            m_reference = reference;
         }
     private:
         const char * m_name;
+        ScriptSymbol m_symbol;
         IScriptValue *m_value;
+        ScriptNumberValue* m_number;
+        ScriptValueReference* m_reference;
     };
     // ScriptVariableGenerator: ??? rand, trig, ...
-    class FunctionArgs {
+    class FunctionArgs : public ArenaObject {
         public:
             FunctionArgs() {}
             virtual ~FunctionArgs() {}
@@ -184,8 +233,9 @@ namespace DevRelief
             FunctionArgs* clone()  {
                 FunctionArgs* other = new FunctionArgs();
                 args.each([&](IScriptValue* val) {
-                    add(val->clone());
+                    other->add(val->clone());
                 });
+                return other;
             }
 
             void add(IScriptValue* val) { args.add(val);}
@@ -200,13 +250,7 @@ namespace DevRelief
     {
     public:
         static bool isFunctionName(const char * val) {
-            if (val == NULL || val[0] == NULL) {return false;}
-            for(int i=0;functionNames[i] != NULL;i++) {
-                if (Util::equal(val,functionNames[i])){
-                    return true;
-                }
-            }
-            return false;
+            return functionNameToOp(val) != FUNC_UNKNOWN;
         }
     public:
         ScriptFunction(const char *name, FunctionArgs* args=NULL) : m_name(name)
@@ -217,12 +261,16 @@ namespace DevRelief
             } else {
                 m_args = args;
             }
+            m_op = functionNameToOp(name);
             m_funcState = -1;
+            m_program = NULL;
+            m_compiled = false;
         }
 
         virtual ~ScriptFunction()
         {
             delete m_args;
+            if (m_program) { m_program->destroy();}
         }
 
         IScriptValue* clone()const override {
@@ -230,6 +278,12 @@ namespace DevRelief
         }
         void addArg(IScriptValue*val) {
             m_args->add(val);
+            // args are only added while loading.  recompile if that ever changes
+            if (m_program) { 
+                m_program->destroy();
+                m_program = NULL;
+            }
+            m_compiled = false;
         }
         int getIntValue(IScriptContext* ctx,  int defaultValue) override
         {
@@ -238,9 +292,27 @@ namespace DevRelief
 
         double getFloatValue(IScriptContext* ctx,  double defaultValue) override
         {
+            if (!m_compiled) {
+                compileProgram();
+            }
+            if (m_program) {
+                return m_program->run(ctx,defaultValue);
+            }
             return invoke(ctx,defaultValue);
         }
 
+        // programs without random values or sequences run once for the whole range
+        void getFloatValues(IScriptContext* ctx, int first, int count, double defaultValue, double* values) override {
+            if (!m_compiled) {
+                compileProgram();
+            }
+            if (m_program && m_program->canRunRange()) {
+                m_program->runRange(ctx,first,count,defaultValue,values);
+            } else {
+                getEachFloatValue(this,ctx,first,count,defaultValue,values);
+            }
+        }
+
        bool getBoolValue(IScriptContext* ctx,  bool defaultValue) override
         {
             double d = getFloatValue(ctx,0);
@@ -267,33 +339,178 @@ namespace DevRelief
             return json;
         }
 
+        // nested functions are compiled into the parent's program.
+        // the argument defaults match getArgValue() in the invoke...() methods.
+        void compile(ScriptProgram* program) override {
+            switch(m_op) {
+                case FUNC_RAND:
+                    compileArg(program,0,0);
+                    if (m_args->length() > 1) {
+                        program->beginDefaultFromTopInt();
+                        m_args->get(1)->compile(program);
+                        program->endDefault();
+                    } else {
+                        program->dupInt();
+                    }
+                    program->operation(OP_RAND,2);
+                    break;
+                case FUNC_ADD:
+                    compileBinary(program,OP_ADD);
+                    break;
+                case FUNC_SUBTRACT:
+                    if (m_args->length() == 1) {
+                        compileArg(program,0);
+                        program->operation(OP_NEG,1);
+                    } else {
+                        compileBinary(program,OP_SUB);
+                    }
+                    break;
+                case FUNC_MULTIPLY:
+                    compileBinary(program,OP_MUL);
+                    break;
+                case FUNC_DIVIDE:
+                    compileBinary(program,OP_DIV);
+                    break;
+                case FUNC_MOD:
+                    compileBinary(program,OP_MOD);
+                    break;
+                case FUNC_MIN:
+                    compileBinary(program,OP_MIN);
+                    break;
+                case FUNC_MAX:
+                    compileBinary(program,OP_MAX);
+                    break;
+                case FUNC_RAND_OF:
+                    compileRandomOf(program);
+                    break;
+                case FUNC_SEQUENCE:
+                    compileArg(program,0,0);
+                    compileArg(program,1,100);
+                    compileArg(program,2,1);
+                    program->sequence(3);
+                    break;
+                default:
+                    program->loadValue(this);
+            }
+        }
+
+        // random values and sequences are different each time they are evaluated.
+        // other functions only change when their args do
+        ValueDependence getDependence(IScriptContext* ctx) override {
+            if (m_op == FUNC_UNKNOWN || m_op == FUNC_RAND || m_op == FUNC_RAND_OF || m_op == FUNC_SEQUENCE) {
+                return VALUE_PER_LED;
+            }
+            ValueDependence result = VALUE_CONSTANT;
+            m_args->args.each([&](IScriptValue* arg) {
+                ValueDependence argDependence = arg ? arg->getDependence(ctx) : VALUE_CONSTANT;
+                if (argDependence > result) {
+                    result = argDependence;
+                }
+            });
+            return result;
+        }
         
     protected:
+        void compileProgram() {
+            m_compiled = true;
+            if (m_op == FUNC_UNKNOWN) {
+                return;
+            }
+            ScriptProgram* program = new ScriptProgram();
+            compile(program);
+            program->end();
+            if (program->isValid()) {
+                m_program = program;
+                m_logger->never("compiled %s: %d instructions",m_name.get(),program->getInstructionCount());
+            } else {
+                m_logger->warn("function %s is too large to compile",m_name.get());
+                program->destroy();
+            }
+        }
+
+        // missing args use the caller's default
+        void compileArg(ScriptProgram* program, int idx) {
+            IScriptValue* val = m_args->get(idx);
+            if (val) {
+                val->compile(program);
+            } else {
+                program->pushDefault();
+            }
+        }
+
+        void compileArg(ScriptProgram* program, int idx, double defaultValue) {
+            IScriptValue* val = m_args->get(idx);
+            if (val) {
+                program->beginDefault(defaultValue);
+                val->compile(program);
+                program->endDefault();
+            } else {
+                program->pushConstant(defaultValue);
+            }
+        }
+
+        void compileBinary(ScriptProgram* program, ScriptOpCode op) {
+            compileArg(program,0);
+            compileArg(program,1);
+            program->operation(op,2);
+        }
+
+        void compileRandomOf(ScriptProgram* program) {
+            int count = m_args->length();
+            if (count == 0) {
+                program->pushDefault();
+                return;
+            }
+            int table = program->beginChoices(count);
+            LinkedList<int> jumps;
+            int choice = 0;
+            m_args->args.each([&](IScriptValue* arg) {
+                program->beginChoice(table,choice);
+                arg->compile(program);
+                jumps.add(program->endChoice(choice));
+                choice++;
+            });
+            jumps.each([&](int jump) {
+                program->setJumpTarget(jump);
+            });
+        }
+
+        // used if the function could not be compiled
         double invoke(IScriptContext * ctx,double defaultValue) {
             double result = 0;
-            const char * name = m_name.get();
-            if (Util::equal("rand",name)){
-                result = invokeRand(ctx,defaultValue);
-            } else if (Util::equal("add",name) || Util::equal("+",name)) {
-                result = invokeAdd(ctx,defaultValue);
-            } else if (Util::equal("subtract",name) ||Util::equal("sub",name) || Util::equal("-",name)) {
-                result = invokeSubtract(ctx,defaultValue);
-            } else if (Util::equal("multiply",name) || Util::equal("mult",name) || Util::equal("*",name)) {
-                result = invokeMultiply(ctx,defaultValue);
-            } else if (Util::equal("divide",name) || Util::equal("div",name) || Util::equal("/",name)) {
-                result = invokeDivide(ctx,defaultValue);
-            } else if (Util::equal("mod",name) || Util::equal("%",name)) {
-                result = invokeMod(ctx,defaultValue);
-            } else if (Util::equal("min",name)) {
-                result = invokeMin(ctx,defaultValue);
-            } else if (Util::equal("max",name)) {
-                result = invokeMax(ctx,defaultValue);
-            } else if (Util::equal("randOf",name)) {
-                result = invokeRandomOf(ctx,defaultValue);
-            } else if (Util::equal("seq",name)||Util::equal("sequence",name)) {
-                result = invokeSequence(ctx,defaultValue);
-            } else {
-                m_logger->error("unknown function: %s",name);
+            switch(m_op) {
+                case FUNC_RAND:
+                    result = invokeRand(ctx,defaultValue);
+                    break;
+                case FUNC_ADD:
+                    result = invokeAdd(ctx,defaultValue);
+                    break;
+                case FUNC_SUBTRACT:
+                    result = invokeSubtract(ctx,defaultValue);
+                    break;
+                case FUNC_MULTIPLY:
+                    result = invokeMultiply(ctx,defaultValue);
+                    break;
+                case FUNC_DIVIDE:
+                    result = invokeDivide(ctx,defaultValue);
+                    break;
+                case FUNC_MOD:
+                    result = invokeMod(ctx,defaultValue);
+                    break;
+                case FUNC_MIN:
+                    result = invokeMin(ctx,defaultValue);
+                    break;
+                case FUNC_MAX:
+                    result = invokeMax(ctx,defaultValue);
+                    break;
+                case FUNC_RAND_OF:
+                    result = invokeRandomOf(ctx,defaultValue);
+                    break;
+                case FUNC_SEQUENCE:
+                    result = invokeSequence(ctx,defaultValue);
+                    break;
+                default:
+                    m_logger->error("unknown function: %s",m_name.get());
             }
             m_logger->never("function: %s=%f",m_name.get(),result);
             return result;
@@ -346,7 +563,7 @@ namespace DevRelief
         double invokeMod(IScriptContext*ctx,double defaultValue) {
             double first = getArgValue(ctx,0,defaultValue);
             double second = getArgValue(ctx,1,defaultValue);
-            return (double)((int)first % (int)second);
+            return ((int)second == 0) ? 0 : (double)((int)first % (int)second);
         }
         
         double invokeMin(IScriptContext*ctx,double defaultValue) {
@@ -396,8 +613,11 @@ namespace DevRelief
         }
 
         DRString m_name;
+        ScriptFunctionOp m_op;
         FunctionArgs * m_args;
         double m_funcState; // different functions can use in their way
+        ScriptProgram* m_program;
+        bool m_compiled;
     };
 
     class ScriptNumberValue : public ScriptValue
@@ -419,6 +639,8 @@ namespace DevRelief
         {
         }
 
+        void setValue(double value) { m_value = value;}
+
         virtual int getIntValue(IScriptContext* ctx,  int defaultValue) override
         {
             int v = m_value;
@@ -442,9 +664,14 @@ namespace DevRelief
         bool isNumber(IScriptContext* ctx) const override { return true;}
 
         virtual DRString toString() { return DRString::fromFloat(m_value); }
-        IJsonElement* toJson(JsonRoot*root) override { return new JsonFloat(root,m_value);}
+        IJsonElement* toJson(JsonRoot*root) override { return root->createFloat(m_value);}
         DRString stringify() override { return DRString::fromFloat(m_value);}
         IScriptValue* clone() const override{ return new ScriptNumberValue(m_value);}
+        void compile(ScriptProgram* program) override { program->pushConstant(m_value);}
+        ValueDependence getDependence(IScriptContext* ctx) override { return VALUE_CONSTANT;}
+        void getFloatValues(IScriptContext* ctx, int first, int count, double defaultValue, double* values) override {
+            fillFloatValues(m_value,count,values);
+        }
 
         void setNumberValue(double val) { m_value = val;}
     protected:
@@ -482,7 +709,7 @@ namespace DevRelief
             return defaultValue;
         }
         bool isBool(IScriptContext* ctx) const override { return true;}
-        IJsonElement* toJson(JsonRoot*root) override { return new JsonBool(root,m_value);}
+        IJsonElement* toJson(JsonRoot*root) override { return root->createBool(m_value);}
 
         DRString toString() override { 
             const char * val =  m_value ? "true":"false"; 
@@ -492,6 +719,11 @@ namespace DevRelief
 
         DRString stringify() override { return m_value ? "true":"false";}
         IScriptValue* clone() const override{ return new ScriptBoolValue(m_value);}
+        void compile(ScriptProgram* program) override { program->pushConstant(m_value ? 1 : 0);}
+        ValueDependence getDependence(IScriptContext* ctx) override { return VALUE_CONSTANT;}
+        void getFloatValues(IScriptContext* ctx, int first, int count, double defaultValue, double* values) override {
+            fillFloatValues(m_value ? 1 : 0,count,values);
+        }
 
     protected:
         bool m_value;
@@ -534,7 +766,7 @@ namespace DevRelief
             return true;  
         } 
 
-        IJsonElement* toJson(JsonRoot*root) override { return new JsonNull(root);}
+        IJsonElement* toJson(JsonRoot*root) override { return root->createNull();}
 
         DRString toString() override { 
             m_logger->debug("ScriptNulllValue.toString()");
@@ -545,6 +777,11 @@ namespace DevRelief
 
         DRString stringify() override { return "null";}
         IScriptValue* clone() const override { return new ScriptNullValue();}
+        void compile(ScriptProgram* program) override { program->pushDefault();}
+        ValueDependence getDependence(IScriptContext* ctx) override { return VALUE_CONSTANT;}
+        void getFloatValues(IScriptContext* ctx, int first, int count, double defaultValue, double* values) override {
+            fillFloatValues(defaultValue,count,values);
+        }
     protected:
 
     };
@@ -607,7 +844,7 @@ namespace DevRelief
         }
 
         bool isString(IScriptContext* ctx) const override { return true;}
-        IJsonElement* toJson(JsonRoot*root) override { return new JsonString(root,m_value);}
+        IJsonElement* toJson(JsonRoot*root) override { return root->createString(m_value);}
 
         const char * getValue() { return m_value.text();}
 
@@ -617,6 +854,10 @@ namespace DevRelief
         IScriptValue* clone()const override {
             return new ScriptStringValue(m_value);
         }
+        ValueDependence getDependence(IScriptContext* ctx) override { return VALUE_CONSTANT;}
+        void getFloatValues(IScriptContext* ctx, int first, int count, double defaultValue, double* values) override {
+            fillFloatValues(getFloatValue(ctx,defaultValue),count,values);
+        }
     protected:
         DRString m_value;
     };
@@ -669,7 +910,7 @@ namespace DevRelief
 
  
 
-    class PatternInterpolation {
+    class PatternInterpolation : public ArenaObject {
         public:
             PatternInterpolation() {
                 SET_LOGGER(ScriptValueLogger);
@@ -724,11 +965,7 @@ namespace DevRelief
             if (m_animator == NULL) {
                 return UnitValue(defaultValue,defaultUnit);
             }
-            m_pixelCount = 0;
-            m_elements.each([&](ScriptPatternElement* element) {
-                element->update(ctx);
-                m_pixelCount += element->getPixelCount();
-            });
+            updateElements(ctx);
             m_animator->update(ctx);
 
             double pct = m_animator->getRangeValue(ctx);
@@ -788,9 +1025,46 @@ namespace DevRelief
 
         size_t getCount() { return m_pixelCount;}
 
+        // same as getUnitValue() for each LED but the pattern elements are only updated once
+        void getFloatValues(IScriptContext* ctx, int first, int count, double defaultValue, double* values) override {
+            if (m_animator == NULL) {
+                fillFloatValues(defaultValue,count,values);
+                return;
+            }
+            updateElements(ctx);
+            PositionDomain* domain = ctx->getAnimationPositionDomain();
+            for(int i=0;i<count;i++) {
+                if (domain) { domain->setPos(first+i);}
+                m_animator->update(ctx);
+                double pct = m_animator->getRangeValue(ctx);
+                values[i] = m_interpolation->getValue(pct,ctx,m_elements,m_pixelCount,defaultValue,POS_INHERIT).getValue();
+            }
+        }
+
+        // position patterns change for each LED.  time patterns change each frame
+        // unless one of the pattern values changes for each LED
+        ValueDependence getDependence(IScriptContext* ctx) override {
+            ValueDependence result = m_animator ? m_animator->getDependence() : VALUE_CONSTANT;
+            m_elements.each([&](ScriptPatternElement* element) {
+                ValueDependence elementDependence = element->getDependence(ctx);
+                if (elementDependence > result) {
+                    result = elementDependence;
+                }
+            });
+            return result;
+        }
+
         
         void setInterpolation(PatternInterpolation*interpolation) { m_interpolation = interpolation;}
     protected:
+        void updateElements(IScriptContext* ctx) {
+            m_pixelCount = 0;
+            m_elements.each([&](ScriptPatternElement* element) {
+                element->update(ctx);
+                m_pixelCount += element->getPixelCount();
+            });
+        }
+
         StepWatcher m_watcher;
         PatternInterpolation* m_interpolation;
         PtrList<ScriptPatternElement*> m_elements;
@@ -817,7 +1091,7 @@ namespace DevRelief
         }
     }
 
-    class InterpolationSegment {
+    class InterpolationSegment : public ArenaObject {
         public:
         InterpolationSegment() {
             startElementIndex=0;
@@ -826,17 +1100,151 @@ namespace DevRelief
             endPercent=1;
         }
         ~InterpolationSegment() {}
-        void destroy() { delete this;}
         int startElementIndex;
         int endElementIndex;
         double startPercent;
         double endPercent;
     };
 
+    // lookup table size is 4 entries per segment within these limits
+    const int PATTERN_LOOKUP_MIN=8;
+    const int PATTERN_LOOKUP_MAX=256;
+
+    /* Segments are kept in an array with a lookup table from a percent to the first segment
+     * that can contain it so finding the segment for an LED does not search the list.
+     * The segments only depend on the element pixel counts so they are rebuilt
+     * when an element is added or a pixel count changes, not every step.
+     */
+    class SegmentInterpolation : public PatternInterpolation {
+        public:
+            SegmentInterpolation() : PatternInterpolation() {
+                m_segments = NULL;
+                m_segmentCount = 0;
+                m_elements = NULL;
+                m_elementPixels = NULL;
+                m_elementCount = 0;
+                m_totalPixels = -1;
+                m_lookup = NULL;
+                m_lookupSize = 0;
+            }
+
+            virtual ~SegmentInterpolation() {
+                delete [] m_segments;
+                free(m_elements);
+                free(m_elementPixels);
+                free(m_lookup);
+            }
+
+        protected:
+            // rebuild the segments if the elements changed since the last step
+            void update(IScriptContext* ctx, LinkedList<ScriptPatternElement*>& elements, int totalPixels) {
+                if (m_stepWatcher.isChanged(ctx) && updateElements(elements,totalPixels)) {
+                    setupSegments(totalPixels);
+                    setupLookup();
+                }
+            }
+
+            virtual void setupSegments(int totalPixels)=0;
+
+            ScriptPatternElement* getElement(int index) const {
+                return index >= 0 && index < m_elementCount ? m_elements[index] : NULL;
+            }
+
+            void setSegmentCount(int count) {
+                if (count != m_segmentCount) {
+                    delete [] m_segments;
+                    m_segments = count > 0 ? new InterpolationSegment[count] : NULL;
+                    m_segmentCount = count;
+                }
+            }
+
+            InterpolationSegment* firstSegment() { return m_segmentCount > 0 ? &m_segments[0] : NULL;}
+            InterpolationSegment* lastSegment() { return m_segmentCount > 0 ? &m_segments[m_segmentCount-1] : NULL;}
+
+            // the first segment with startPercent <= pct < endPercent.  segment ends never decrease
+            InterpolationSegment* findSegment(double pct) {
+                if (!(pct > 0 && pct < 1) || m_lookupSize == 0) {
+                    // no segment starts before 0.  NaN is not in any segment
+                    for(int i=0;i<m_segmentCount;i++) {
+                        if (m_segments[i].startPercent<=pct && m_segments[i].endPercent > pct) {
+                            return &m_segments[i];
+                        }
+                    }
+                    return NULL;
+                }
+                int index = m_lookup[(int)(pct*m_lookupSize)];
+                // pct*m_lookupSize can round up to the next entry
+                while(index > 0 && m_segments[index-1].endPercent > pct) {
+                    index--;
+                }
+                for(int i=index;i<m_segmentCount;i++) {
+                    InterpolationSegment& segment = m_segments[i];
+                    if (segment.startPercent<=pct && segment.endPercent > pct) {
+                        return &segment;
+                    }
+                }
+                return NULL;
+            }
+
+            InterpolationSegment* m_segments;
+            int m_segmentCount;
+            ScriptPatternElement** m_elements;
+            int m_elementCount;
+        private:
+            // returns true if the element list or a pixel count is different from the last call
+            bool updateElements(LinkedList<ScriptPatternElement*>& elements, int totalPixels) {
+                int count = elements.size();
+                bool changed = count != m_elementCount || totalPixels != m_totalPixels;
+                if (count != m_elementCount) {
+                    m_elements = (ScriptPatternElement**)realloc(m_elements,count*sizeof(ScriptPatternElement*));
+                    m_elementPixels = (int*)realloc(m_elementPixels,count*sizeof(int));
+                    m_elementCount = count;
+                }
+                int index = 0;
+                elements.each([&](ScriptPatternElement* element) {
+                    int pixels = element->getPixelCount();
+                    if (!changed && (m_elements[index] != element || m_elementPixels[index] != pixels)) {
+                        changed = true;
+                    }
+                    m_elements[index] = element;
+                    m_elementPixels[index] = pixels;
+                    index++;
+                });
+                m_totalPixels = totalPixels;
+                return changed;
+            }
+
+            // m_lookup[i] is the first segment that ends after i/m_lookupSize
+            void setupLookup() {
+                int size = m_segmentCount*4;
+                if (size < PATTERN_LOOKUP_MIN) { size = PATTERN_LOOKUP_MIN;}
+                if (size > PATTERN_LOOKUP_MAX) { size = PATTERN_LOOKUP_MAX;}
+                if (m_segmentCount == 0) { size = 0;}
+                if (size != m_lookupSize) {
+                    m_lookup = (uint16_t*)realloc(m_lookup,size*sizeof(uint16_t));
+                    m_lookupSize = size;
+                }
+                int segment = 0;
+                for(int i=0;i<size;i++) {
+                    double pct = (double)i/size;
+                    while(segment < m_segmentCount-1 && !(m_segments[segment].endPercent > pct)) {
+                        segment++;
+                    }
+                    m_lookup[i] = segment;
+                }
+            }
+
+            StepWatcher m_stepWatcher;
+            int* m_elementPixels;
+            int m_totalPixels;
+            uint16_t* m_lookup;
+            int m_lookupSize;
+    };
+
 
-    class SmoothInterpolation : public PatternInterpolation {
+    class SmoothInterpolation : public SegmentInterpolation {
         public:
-            SmoothInterpolation() :PatternInterpolation() {
+            SmoothInterpolation() : SegmentInterpolation() {
                 
             }
             virtual ~SmoothInterpolation() {
@@ -844,14 +1252,11 @@ namespace DevRelief
             }
 
             UnitValue getValue(double pct, IScriptContext* ctx, LinkedList<ScriptPatternElement*>& elements,int pixelCount, double defaultValue, PositionUnit defaultUnit) {
-                if (m_stepWatcher.isChanged(ctx)) {
-                    m_logger->never("update SmoothInterpolation segments");
-                    setupSegments(elements,pixelCount);
-                }
-                InterpolationSegment* segment = findSegment(pct,elements);
+                update(ctx,elements,pixelCount);
+                InterpolationSegment* segment = findSmoothSegment(pct);
                 if (segment != NULL) {
-                    ScriptPatternElement* start = elements.get(segment->startElementIndex);
-                    ScriptPatternElement* end = elements.get(segment->endElementIndex);
+                    ScriptPatternElement* start = getElement(segment->startElementIndex);
+                    ScriptPatternElement* end = getElement(segment->endElementIndex);
                     if (start != NULL && start->getValue() != NULL && end == NULL){
                         m_logger->never("no start.  return end value");
                         return start->getValue()->getUnitValue(ctx,defaultValue,defaultUnit);
@@ -878,12 +1283,12 @@ namespace DevRelief
                 return true;
             }
         protected:
-            void setupSegments(LinkedList<ScriptPatternElement*>& elements,int totalPixels) {
-                int elementCount = elements.size();
+            void setupSegments(int totalPixels) override {
+                int elementCount = m_elementCount;
                 if (elementCount<3) {
-                    m_segments.clear();
+                    setSegmentCount(elementCount == 0 ? 0 : 1);
                     if (elementCount==0) { return;}
-                    InterpolationSegment* seg = new InterpolationSegment();
+                    InterpolationSegment* seg = &m_segments[0];
                     seg->startElementIndex = 0;
                     seg->endElementIndex = -1;
                     seg->startPercent = 0;
@@ -891,27 +1296,17 @@ namespace DevRelief
                     if (elementCount==2) {
                         seg->endElementIndex=1;
                     }
-                    m_segments.add(seg);
                     return;
 
                 }
-               if (elements.size() != m_segments.size()+1){
-                    m_segments.clear();
-                    for(int i=0;i<elements.size()-1;i++) {
-                        m_segments.add(new InterpolationSegment());
-                    }
-                }
+                setSegmentCount(elementCount-1);
                 double pixelOffset = 0;
-                int startElementIndex = 0;
-                int endElementIndex = 0;
                 double startPct = 0;
-                double endPct = 0;
-                int segmentIndex = 0;
 
                 for(int elementIndex=0;elementIndex<elementCount-1;elementIndex++) {
-                    InterpolationSegment* segment = m_segments.get(elementIndex);
-                    ScriptPatternElement* start = elements.get(elementIndex);                    
-                    ScriptPatternElement* end = elements.get(elementIndex+1);
+                    InterpolationSegment* segment = &m_segments[elementIndex];
+                    ScriptPatternElement* start = m_elements[elementIndex];                    
+                    ScriptPatternElement* end = m_elements[elementIndex+1];
                     segment->startElementIndex = elementIndex;
                     segment->endElementIndex = elementIndex+1;
 
@@ -930,23 +1325,14 @@ namespace DevRelief
 
             }
 
-            InterpolationSegment* findSegment(double pct,LinkedList<ScriptPatternElement*>& elements) {
-                m_logger->never("find segment %.2f of %d",pct,m_segments.size());
-               if (pct == 0 || m_segments.size() <= 2) {
-                    return m_segments.get(0);
+            InterpolationSegment* findSmoothSegment(double pct) {
+               if (pct == 0 || m_segmentCount <= 2) {
+                    return firstSegment();
                 }
                 if (pct >= 1) {
-                    return m_segments.get(m_segments.size()-1);
+                    return lastSegment();
                 }
-                for(int i=0;i<m_segments.size();i++) {
-                    InterpolationSegment* segment = m_segments.get(i);
-                    if (segment->startPercent<=pct && segment->endPercent > pct) {
-                        return segment;
-                    }
-                    m_logger->never("\tno match %.2f < %.2f < %.2f",segment->startPercent,pct,segment->endPercent);
-
-                }
-                return NULL;
+                return findSegment(pct);
             }
 
             virtual UnitValue interpolate(IScriptContext*ctx, IScriptValue*start,IScriptValue*end, double pct, double defaultValue, PositionUnit defaultUnit){
@@ -971,26 +1357,21 @@ namespace DevRelief
                 return UnitValue(result,suv.getUnit());
 
             }     
-
-            StepWatcher m_stepWatcher;  
-            PtrList<InterpolationSegment*> m_segments;    
     };
 
-    class StepInterpolation : public PatternInterpolation {
+    class StepInterpolation : public SegmentInterpolation {
         public:
-            StepInterpolation() :PatternInterpolation() {
+            StepInterpolation() : SegmentInterpolation() {
             }
             virtual ~StepInterpolation() {
 
             }
 
             UnitValue getValue(double pct, IScriptContext* ctx, LinkedList<ScriptPatternElement*>& elements,int totalPixels, double defaultValue, PositionUnit defaultUnit) {
-                if (m_stepWatcher.isChanged(ctx)) {
-                    setupSegments(elements,totalPixels);
-                }
-                InterpolationSegment* segment = findSegment(pct,elements);
+                update(ctx,elements,totalPixels);
+                InterpolationSegment* segment = findStepSegment(pct);
                 if (segment) {
-                    ScriptPatternElement*element = elements.get(segment->startElementIndex);
+                    ScriptPatternElement*element = getElement(segment->startElementIndex);
                     IScriptValue* val = element ? element->getValue() : NULL;
                     if (val) {
                         return val->getUnitValue(ctx,defaultValue,defaultUnit);
@@ -1004,44 +1385,28 @@ namespace DevRelief
                 return true;
             }
         protected:
-            void setupSegments(LinkedList<ScriptPatternElement*>& elements,int totalPixels) {
-                if (elements.size() != m_segments.size()){
-                    m_segments.clear();
-                    for(int i=0;i<elements.size();i++) {
-                        m_segments.add(new InterpolationSegment());
-                    }
-                }
+            void setupSegments(int totalPixels) override {
+                setSegmentCount(m_elementCount);
                 double pixelOffset = 0;
-                int index = 0;
-                int pct = 0;
-                elements.each([&](ScriptPatternElement* element){
-                    InterpolationSegment* segment = m_segments.get(index);
+                for(int index=0;index<m_elementCount;index++) {
+                    InterpolationSegment* segment = &m_segments[index];
                     segment->startElementIndex = index;
                     segment->endElementIndex = index;
                     segment->startPercent = pixelOffset/totalPixels;
-                    index++;
-                    pixelOffset += element->getPixelCount();
+                    pixelOffset += m_elements[index]->getPixelCount();
                     segment->endPercent = pixelOffset/totalPixels;
-                });
+                }
             }
 
-            InterpolationSegment* findSegment(double pct,LinkedList<ScriptPatternElement*>& elements) {
+            InterpolationSegment* findStepSegment(double pct) {
                 if (pct <= 0) {
-                    return m_segments.get(0);
+                    return firstSegment();
                 }
                 if (pct >= 1) {
-                    return m_segments.get(m_segments.size()-1);
+                    return lastSegment();
                 }
-                for(int i=0;i<m_segments.size();i++) {
-                    InterpolationSegment* segment = m_segments.get(i);
-                    if (segment->startPercent<=pct && segment->endPercent > pct) {
-                        return segment;
-                    }
-                }
-                return NULL;
+                return findSegment(pct);
             }
-            PtrList<InterpolationSegment*> m_segments;        
-            StepWatcher m_stepWatcher;   
     };
 
     class PatternRange : public AnimationRange {
@@ -1081,7 +1446,7 @@ namespace DevRelief
             }
 
             /* extends pattern to full length of strip */
-            double getValue(double position) {
+            double getValue(Real position) {
                 int count = m_pattern ? m_pattern->getCount() : 0;
                 if (count < 2) { return 0;}
                 m_logger->never("getValue");
@@ -1111,7 +1476,7 @@ namespace DevRelief
             }
 
             /* repeat pattern */
-            double getValue(double position) {
+            double getValue(Real position) {
                 int count = m_pattern ? m_pattern->getCount() : 0;
                 if (count < 2) { return 0;}
 
@@ -1139,29 +1504,41 @@ namespace DevRelief
             bool m_alternate;
     };
 
+    typedef enum ScriptSysValue {
+        SYS_NAMED=0,    // value set in a context with setSysValue()
+        SYS_OFFSET,
+        SYS_LENGTH,
+        SYS_LED,
+        SYS_STEP
+    };
+
     class ScriptVariableValue : public IScriptValue
     {
     public:
         ScriptVariableValue(bool isSysValue, const char *value,IScriptValue* defaultValue) 
         {
             SET_LOGGER(ScriptValueLogger);
-            m_name = Util::allocText(value);
+            m_name = Arena::copyText(value);
             m_logger->debug("Created ScriptVariableValue %s %d.", value, isSysValue);
             m_defaultValue = defaultValue;
             m_isSysValue = isSysValue;
             m_recurse = false;
+            resolveName();
         }
 
         ScriptVariableValue(const ScriptVariableValue* other){
-            m_name = Util::allocText(other->m_name);
+            SET_LOGGER(ScriptValueLogger);
+            m_name = Arena::copyText(other->m_name);
             m_defaultValue = other->m_defaultValue ? other->m_defaultValue->clone() : NULL;
             m_isSysValue = other->m_isSysValue;
             m_recurse = false;
+            m_sysValue = other->m_sysValue;
+            m_symbol = other->m_symbol;
         }
 
         virtual ~ScriptVariableValue()
         {
-            Util::freeText(m_name);
+            Arena::freeText(m_name);
             if (m_defaultValue) { m_defaultValue->destroy();}
         }
 
@@ -1179,29 +1556,32 @@ namespace DevRelief
                 m_logger->never("variable getFloatValue() recurse");
                 return m_defaultValue ? m_defaultValue->getFloatValue(ctx,defaultValue) : defaultValue;
             }
-            if (m_isSysValue && Util::equal("offset",m_name)){
-                IElementPosition*pos = ctx->getPosition();
-                if (pos && pos->hasLength()) {
-                    return pos->getOffset().getValue();
-                } else {
-                    return 0;
+            switch(m_sysValue) {
+                case SYS_OFFSET: {
+                    IElementPosition*pos = ctx->getPosition();
+                    if (pos && pos->hasLength()) {
+                        return pos->getOffset().getValue();
+                    } else {
+                        return 0;
+                    }
                 }
-            }
-            if (m_isSysValue && Util::equal("length",m_name)){
-                IElementPosition*pos = ctx->getPosition();
-                if (pos && pos->hasLength()) {
-                    return pos->getLength().getValue();
-                } else {
-                    return ctx->getStrip()->getLength();
+                case SYS_LENGTH: {
+                    IElementPosition*pos = ctx->getPosition();
+                    if (pos && pos->hasLength()) {
+                        return pos->getLength().getValue();
+                    } else {
+                        return ctx->getStrip()->getLength();
+                    }
                 }
-            }
-            if (m_isSysValue && Util::equal("led",m_name)){
-                return ctx->getAnimationPositionDomain()->getValue();
-            }
-            if (m_isSysValue && Util::equal("step",m_name)){
-                int step =  ctx->getStep()->getNumber();
-                m_logger->never("sys(step)=%d  %x",step,ctx);
-                return step;
+                case SYS_LED:
+                    return ctx->getAnimationPositionDomain()->getValue();
+                case SYS_STEP: {
+                    int step =  ctx->getStep()->getNumber();
+                    m_logger->never("sys(step)=%d  %x",step,ctx);
+                    return step;
+                }
+                default:
+                    break;
             }
             m_recurse = true;
 
@@ -1293,7 +1673,7 @@ namespace DevRelief
                 }
                 
             }
-            return new JsonString(jsonRoot,val.text());
+            return jsonRoot->createString(val.text());
         }
         
         virtual DRString toString() { return DRString("Variable: ").append(m_name); }
@@ -1305,9 +1685,81 @@ namespace DevRelief
             m_logger->error(LM("AnimatedValue.clone() not implemented"));
             return new ScriptVariableValue(this);
         }
+
+        void compile(ScriptProgram* program) override { program->loadValue(this);}
+
+        ValueDependence getDependence(IScriptContext* ctx) override {
+            switch(m_sysValue) {
+                case SYS_OFFSET:
+                case SYS_LENGTH:
+                case SYS_STEP:
+                    return VALUE_PER_FRAME;
+                case SYS_LED:
+                    return VALUE_PER_LED;
+                default:
+                    break;
+            }
+            if (ctx == NULL || m_recurse) {
+                return VALUE_PER_LED;
+            }
+            m_recurse = true;
+            ValueDependence result = getScriptValue(ctx)->getDependence(ctx);
+            m_recurse = false;
+            return result;
+        }
+
+        void getFloatValues(IScriptContext* ctx, int first, int count, double defaultValue, double* values) override {
+            if (m_recurse) {
+                ScriptValue::getEachFloatValue(this,ctx,first,count,defaultValue,values);
+                return;
+            }
+            switch(m_sysValue) {
+                case SYS_LED:
+                    for(int i=0;i<count;i++) {
+                        values[i] = first+i;
+                    }
+                    return;
+                case SYS_OFFSET:
+                case SYS_LENGTH:
+                case SYS_STEP:
+                    ScriptValue::fillFloatValues(getFloatValue(ctx,defaultValue),count,values);
+                    return;
+                default:
+                    break;
+            }
+            m_recurse = true;
+            getScriptValue(ctx)->getFloatValues(ctx,first,count,defaultValue,values);
+            m_recurse = false;
+        }
     protected:
+        // names are resolved when the variable is created so lookups do not compare strings.
+        // sys values are stored in the context as "sys:name"
+        void resolveName() {
+            m_sysValue = SYS_NAMED;
+            if (m_isSysValue) {
+                if (Util::equal("offset",m_name)) {
+                    m_sysValue = SYS_OFFSET;
+                } else if (Util::equal("length",m_name)) {
+                    m_sysValue = SYS_LENGTH;
+                } else if (Util::equal("led",m_name)) {
+                    m_sysValue = SYS_LED;
+                } else if (Util::equal("step",m_name)) {
+                    m_sysValue = SYS_STEP;
+                }
+                DRFormattedString fullName("sys:%s",m_name);
+                m_symbol = ScriptSymbols::intern(fullName.text());
+            } else {
+                m_symbol = ScriptSymbols::intern(m_name);
+            }
+        }
+
         IScriptValue* getScriptValue(IScriptContext*context) const {
-            IScriptValue* val = m_isSysValue ? context->getSysValue(m_name) : context->getValue(m_name);
+            IScriptValue* val = NULL;
+            if (m_symbol != SYMBOL_NONE) {
+                val = context->getSymbolValue(m_symbol);
+            } else {
+                val = m_isSysValue ? context->getSysValue(m_name) : context->getValue(m_name);
+            }
             if (val == NULL)  {
                 val = m_defaultValue;
             }
@@ -1316,6 +1768,8 @@ namespace DevRelief
         }
         const char * m_name;
         bool m_isSysValue;
+        ScriptSysValue m_sysValue;
+        ScriptSymbol m_symbol;
         IScriptValue*  m_defaultValue;
         DECLARE_LOGGER();
         bool m_recurse;
@@ -1330,6 +1784,8 @@ namespace DevRelief
             ScriptValueList() {
                 SET_LOGGER(ScriptValueLogger);
                 m_logger->never("create ScriptValueList()");
+                m_slots = NULL;
+                m_slotCount = 0;
             }
 
 
@@ -1337,6 +1793,7 @@ namespace DevRelief
             virtual ~ScriptValueList() {
                 m_logger->debug("delete ~ScriptValueList()");
                 clear();
+                free(m_slots);
                 m_logger->debug("cleared");
             }
 
@@ -1351,17 +1808,20 @@ namespace DevRelief
                     return strcmp(nv->getName(),name)==0;
                 });
                 if (first) {
-                    IScriptValue* found = (*first)->getValue();
-                    if (found) {
-                        m_logger->never("\tfound %s",found->toString().text());
-                        return found;
-                    }
+                    return (*first)->getValue();
                 }
 
                 m_logger->never("\tnot found");
                 return NULL;
             }
 
+            IScriptValue* getSymbolValue(ScriptSymbol symbol) override {
+                if (symbol < 0 || symbol >= m_slotCount || m_slots[symbol] == NULL) {
+                    return NULL;
+                }
+                return m_slots[symbol]->getValue();
+            }
+
             void setValue(const char * name,IScriptValue * value) {
                 if (Util::isEmpty(name) || value == NULL) {
                     return;
@@ -1374,8 +1834,18 @@ namespace DevRelief
                     return;
                 }
                 m_logger->never("add NameValue %s  0x%04X",name,value);
-                NameValue* nv = new NameValue(name,value);
-                m_values.add(nv);
+                add(new NameValue(name,value));
+            }
+
+            void setNumber(const char * name, double value) override {
+                NameValue* nv = findOrAdd(name);
+                if (nv) { nv->setNumber(value);}
+            }
+
+            void setReference(const char * name, IScriptValue* target) override {
+                if (target == NULL) { return;}
+                NameValue* nv = findOrAdd(name);
+                if (nv) { nv->setReference(target);}
             }
 
             void each(auto&& lambda) const {
@@ -1388,24 +1858,72 @@ namespace DevRelief
 
             void initialize(ScriptValueList* source,IScriptContext*ctx) override {
                 m_logger->never("initialize ScriptValueList from source %x",source);
-                m_values.clear();
+                clear();
                 if(source == NULL) { return;}
                 source->each([&](NameValue* nv) {
                     IScriptValue* val = nv->getValue();
                     if (val != NULL) {
                         IScriptValue* newVal = val->eval(ctx);
-                        NameValue*newNV = new NameValue(nv->getName(),newVal);
-                        m_values.add(newNV);
+                        add(new NameValue(nv->getName(),newVal));
                     }
                 });
             }
 
-            void clear() { m_values.clear();}
+            void clear() { 
+                m_values.clear();
+                if (m_slots) {
+                    memset(m_slots,0,m_slotCount*sizeof(NameValue*));
+                }
+            }
         private:
+            NameValue* findOrAdd(const char * name) {
+                if (Util::isEmpty(name)) {
+                    return NULL;
+                }
+                NameValue** find = m_values.first([&](NameValue*&nv) {
+                    return strcmp(nv->getName(),name)==0;
+                });
+                if (find) {
+                    return *find;
+                }
+                // the caller sets the value
+                NameValue* nv = new NameValue(name,NULL);
+                add(nv);
+                return nv;
+            }
+
+            void add(NameValue* nv) {
+                m_values.add(nv);
+                ScriptSymbol symbol = nv->getSymbol();
+                if (symbol == SYMBOL_NONE) {
+                    return;
+                }
+                if (symbol >= m_slotCount) {
+                    // slots are indexed by symbol.  only as large as the highest symbol in this list
+                    int count = symbol+1;
+                    m_slots = (NameValue**)realloc(m_slots,count*sizeof(NameValue*));
+                    memset(m_slots+m_slotCount,0,(count-m_slotCount)*sizeof(NameValue*));
+                    m_slotCount = count;
+                }
+                m_slots[symbol] = nv;
+            }
+
             PtrList<NameValue*> m_values;
+            NameValue** m_slots;
+            int m_slotCount;
             DECLARE_LOGGER();
    };
 
+   void NameValue::setNumber(double value) {
+        if (m_number != NULL) {
+            m_number->setValue(value);
+            return;
+        }
+        ScriptNumberValue* number = new ScriptNumberValue(value);
+        replaceValue(number);
+        m_number = number;
+   }
+
    IScriptValue* ScriptValue::eval(IScriptContext * ctx, double defaultValue) {
         return new ScriptNumberValue(getFloatValue(ctx,defaultValue));
    }
@@ -1556,6 +2074,10 @@ namespace DevRelief
             if (Util::equal(easeVal->getString(),"linear")){
                 return new LinearEase();
             }
+            int curve = EaseCurves::indexOf(easeVal->getString());
+            if (curve >= 0) {
+                return new NamedEase(curve);
+            }
         }
         IScriptValue* inValue=NULL;
         IScriptValue* outValue=NULL;
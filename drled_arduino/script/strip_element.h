@@ -92,6 +92,27 @@ namespace DevRelief
 
 
         protected:
+            void parentSetHSL(int16_t hue,int16_t saturation,int16_t lightness,int parentIndex, HSLOperation op) override {
+                m_parent->setHSL(hue,saturation,lightness,parentIndex,op);
+                m_parent->setHSL(hue,saturation,lightness,mirrorIndex(parentIndex),op);
+            }
+
+            // the mirrored span is contiguous and ends at the mirror of parentIndex
+            void parentFillHSL(int16_t hue,int16_t saturation,int16_t lightness,int parentIndex, int count, HSLOperation op) override {
+                m_parent->fillHSL(hue,saturation,lightness,parentIndex,count,op);
+                m_parent->fillHSL(hue,saturation,lightness,mirrorIndex(parentIndex+count-1),count,op);
+            }
+
+            void parentWriteHSL(const HSLSpan& values,int parentIndex, int count, HSLOperation op) override {
+                m_parent->writeHSL(values,parentIndex,count,op);
+                for(int i=0;i<count;i++) {
+                    m_parent->setHSL(values.getHue(i),values.getSaturation(i),values.getLightness(i),mirrorIndex(parentIndex+i),op);
+                }
+            }
+
+
+            bool canMapIndexes() override { return false;}
+
             int mirrorIndex(int idx) {
                 return m_lastLed - (idx-m_offset);
             }
@@ -100,9 +121,167 @@ namespace DevRelief
 
     };
 
-    class CopyStrip : public ScriptHSLStrip {
+    /* children of copy and repeat strips are drawn once into a buffer.  flush() passes each run of
+     * buffered LEDs to blitHSL() which writes it to every destination in the parent.  an LED is flushed
+     * before it is changed again so the parent sees the operations in the order they were drawn.
+     */
+    class BufferedStrip : public ScriptHSLStrip {
+        public:
+            BufferedStrip() : ScriptHSLStrip() {
+                m_bufferSize = 0;
+                m_bufferLength = 0;
+                m_hue = NULL;
+                m_saturation = NULL;
+                m_lightness = NULL;
+                m_operation = NULL;
+                m_first = 0;
+                m_last = -1;
+            }
+
+            virtual ~BufferedStrip() {
+                freeBuffer();
+            }
+
+            void setRGB(const CRGB& rgb,int index, HSLOperation op) override {
+                if (!isPositionValid(index)) { return;}
+                flush();
+                blitRGB(rgb,translateIndex(index),translateOp(op));
+            }
+
+            void setHue(int16_t hue,int index, HSLOperation op) override {
+                if (!isPositionValid(index)) { return;}
+                parentSetHSL(hue,HSL_UNSET,HSL_UNSET,translateIndex(index),translateOp(op));
+            }
+
+            void setSaturation(int16_t saturation,int index, HSLOperation op) override {
+                if (!isPositionValid(index)) { return;}
+                parentSetHSL(HSL_UNSET,saturation,HSL_UNSET,translateIndex(index),translateOp(op));
+            }
+
+            void setLightness(int16_t lightness,int index, HSLOperation op) override {
+                if (!isPositionValid(index)) { return;}
+                parentSetHSL(HSL_UNSET,HSL_UNSET,lightness,translateIndex(index),translateOp(op));
+            }
+
+            // write the buffered LEDs to the parent
+            void flush() {
+                int led = m_first;
+                while(led <= m_last) {
+                    if (!isBuffered(led)) {
+                        led++;
+                        continue;
+                    }
+                    int first = led;
+                    HSLOperation op = m_operation[led];
+                    while(led <= m_last && isBuffered(led) && m_operation[led] == op) {
+                        led++;
+                    }
+                    blitHSL(HSLSpan(m_hue+first,m_saturation+first,m_lightness+first),m_offset+first,led-first,op);
+                }
+                for(led=m_first;led<=m_last;led++) {
+                    m_hue[led] = HSL_UNSET;
+                    m_saturation[led] = HSL_UNSET;
+                    m_lightness[led] = HSL_UNSET;
+                }
+                m_first = m_bufferSize;
+                m_last = -1;
+            }
+
+        protected:
+            // write values to every destination of parentIndex...parentIndex+count-1
+            virtual void blitHSL(const HSLSpan& values,int parentIndex, int count, HSLOperation op)=0;
+            virtual void blitRGB(const CRGB& rgb,int parentIndex, HSLOperation op)=0;
+
+            // LEDs m_offset...m_offset+length-1 are buffered.  their destinations must not overlap
+            void resizeBuffer(int length) {
+                flush();
+                if (length > m_bufferSize) {
+                    allocateBuffer(length);
+                }
+                m_bufferLength = length;
+            }
+
+            void allocateBuffer(int length) {
+                freeBuffer();
+                m_bufferSize = length;
+                m_hue = new int16_t[m_bufferSize];
+                m_saturation = new int16_t[m_bufferSize];
+                m_lightness = new int16_t[m_bufferSize];
+                m_operation = new HSLOperation[m_bufferSize];
+                for(int i=0;i<m_bufferSize;i++) {
+                    m_hue[i] = HSL_UNSET;
+                    m_saturation[i] = HSL_UNSET;
+                    m_lightness[i] = HSL_UNSET;
+                }
+                m_first = m_bufferSize;
+                m_last = -1;
+            }
+
+            void parentSetHSL(int16_t hue,int16_t saturation,int16_t lightness,int parentIndex, HSLOperation op) override {
+                int led = parentIndex-m_offset;
+                if (led < 0 || led >= m_bufferLength) {
+                    // outside the buffer.  it may be a destination of a buffered LED
+                    flush();
+                    blitHSL(HSLSpan(&hue,&saturation,&lightness),parentIndex,1,op);
+                    return;
+                }
+                if (isBuffered(led) && (m_operation[led] != op || (hue != HSL_UNSET && m_hue[led] != HSL_UNSET) 
+                        || (saturation != HSL_UNSET && m_saturation[led] != HSL_UNSET) || (lightness != HSL_UNSET && m_lightness[led] != HSL_UNSET))) {
+                    flush();
+                }
+                if (hue != HSL_UNSET) { m_hue[led] = hue;}
+                if (saturation != HSL_UNSET) { m_saturation[led] = saturation;}
+                if (lightness != HSL_UNSET) { m_lightness[led] = lightness;}
+                m_operation[led] = op;
+                if (led < m_first) { m_first = led;}
+                if (led > m_last) { m_last = led;}
+            }
+
+            void parentFillHSL(int16_t hue,int16_t saturation,int16_t lightness,int parentIndex, int count, HSLOperation op) override {
+                for(int i=0;i<count;i++) {
+                    parentSetHSL(hue,saturation,lightness,parentIndex+i,op);
+                }
+            }
+
+            void parentWriteHSL(const HSLSpan& values,int parentIndex, int count, HSLOperation op) override {
+                for(int i=0;i<count;i++) {
+                    parentSetHSL(values.getHue(i),values.getSaturation(i),values.getLightness(i),parentIndex+i,op);
+                }
+            }
+
+            bool canMapIndexes() override { return false;}
+
+            bool isBuffered(int led) const {
+                return m_hue[led] != HSL_UNSET || m_saturation[led] != HSL_UNSET || m_lightness[led] != HSL_UNSET;
+            }
+
+            void freeBuffer() {
+                delete [] m_hue;
+                delete [] m_saturation;
+                delete [] m_lightness;
+                delete [] m_operation;
+                m_hue = NULL;
+                m_saturation = NULL;
+                m_lightness = NULL;
+                m_operation = NULL;
+                m_bufferSize = 0;
+                m_bufferLength = 0;
+            }
+
+            int m_bufferSize;
+            int m_bufferLength;
+            int16_t* m_hue;
+            int16_t* m_saturation;
+            int16_t* m_lightness;
+            HSLOperation* m_operation;
+            // range of buffered LEDs
+            int m_first;
+            int m_last;
+    };
+
+    class CopyStrip : public BufferedStrip {
         public:
-            CopyStrip() : ScriptHSLStrip() {
+            CopyStrip() : BufferedStrip() {
                 m_count = 0;
                 m_repeatOffset = 0;
             }
@@ -122,48 +301,22 @@ namespace DevRelief
                     m_overflow = OVERFLOW_ALLOW;
                     m_logger->never("copy: %d %d %d %d",m_count,m_length,m_parentLength,m_repeatOffset);
                 }
+                resizeBuffer(m_length);
             }
 
-
-            void setHue(int16_t hue,int index, HSLOperation op) override {
-                if (!isPositionValid(index)) { 
-                    return;
-                }
-                int tidx = translateIndex(index);
-                HSLOperation top = translateOp(op);
-                for(int i=0;i<m_count;i++) {
-                    m_parent->setHue(hue,tidx+i*m_repeatOffset,top);
-                }
-            }
-
-            void setSaturation(int16_t saturation,int index, HSLOperation op) override {
-                if (!isPositionValid(index)) { return;}            
-                int tidx = translateIndex(index);
-                HSLOperation top = translateOp(op);
+        protected:
+            void blitHSL(const HSLSpan& values,int parentIndex, int count, HSLOperation op) override {
                 for(int i=0;i<m_count;i++) {
-                    m_parent->setSaturation(saturation,tidx+i*m_repeatOffset,top);
+                    m_parent->writeHSL(values,parentIndex+i*m_repeatOffset,count,op);
                 }
             }
 
-            void setLightness(int16_t lightness,int index, HSLOperation op) override {
-                if (!isPositionValid(index)) { return;}             
-                int tidx = translateIndex(index);
-                HSLOperation top = translateOp(op);
+            void blitRGB(const CRGB& rgb,int parentIndex, HSLOperation op) override {
                 for(int i=0;i<m_count;i++) {
-                    m_parent->setLightness(lightness,tidx+i*m_repeatOffset,top);
+                    m_parent->setRGB(rgb,parentIndex+i*m_repeatOffset,op);
                 }
             }
 
-            void setRGB(const CRGB& rgb,int index, HSLOperation op) override {
-                if (!isPositionValid(index)) { return;}            
-                int tidx = translateIndex(index);
-                HSLOperation top = translateOp(op);
-                for(int i=0;i<m_count;i++) {
-                    m_parent->setRGB(rgb,tidx+i*m_repeatOffset,top);
-                }                
-            }              
-
-        protected:
             friend class CopyElement;
 
             int m_count;
@@ -171,9 +324,9 @@ namespace DevRelief
 
     };
 
-      class RepeatStrip : public ScriptHSLStrip {
+      class RepeatStrip : public BufferedStrip {
         public:
-            RepeatStrip() : ScriptHSLStrip() {
+            RepeatStrip() : BufferedStrip() {
                 m_repeatLength = 0;
                 m_repeatCount = 0;
             }
@@ -184,55 +337,34 @@ namespace DevRelief
 
             void setRepeatLength(int length) { 
                 m_repeatLength = length;
-                if (m_parentLength >0) {
+                if (m_parentLength >0 && m_repeatLength > 0) {
                     m_repeatCount = m_parentLength/m_repeatLength;
+                } else {
+                    // nothing to repeat (no children with a flow length).  draw once
+                    m_repeatCount = 0;
                 }
+                // LEDs more than one repeat apart write the same parent LEDs so only one repeat is buffered
+                resizeBuffer(m_repeatCount > 0 && m_repeatLength < m_length ? m_repeatLength : m_length);
             }
 
-
-            void setHue(int16_t hue,int index, HSLOperation op) override {
-                if (!isPositionValid(index)) { 
-                    return;
-                }
-                int tidx = translateIndex(index);
-                HSLOperation top = translateOp(op);
-                for(int i=0;i<=m_repeatCount;i++) {
-                    if (tidx+i*m_repeatLength >= m_length) break;
-                    m_parent->setHue(hue,tidx+i*m_repeatLength,top);
-                }
-            }
-
-            void setSaturation(int16_t saturation,int index, HSLOperation op) override {
-                if (!isPositionValid(index)) { return;}            
-                int tidx = translateIndex(index);
-                HSLOperation top = translateOp(op);
+        protected:
+            // each repeat stops at the end of the strip
+            void blitHSL(const HSLSpan& values,int parentIndex, int count, HSLOperation op) override {
                 for(int i=0;i<=m_repeatCount;i++) {
-                    if (tidx+i*m_repeatLength >= m_length) break;
-                    m_parent->setSaturation(saturation,tidx+i*m_repeatLength,top);
+                    int start = parentIndex+i*m_repeatLength;
+                    if (start >= m_length) break;
+                    int repeatCount = start+count > m_length ? m_length-start : count;
+                    m_parent->writeHSL(values,start,repeatCount,op);
                 }
             }
 
-            void setLightness(int16_t lightness,int index, HSLOperation op) override {
-                if (!isPositionValid(index)) { return;}             
-                int tidx = translateIndex(index);
-                HSLOperation top = translateOp(op);
+            void blitRGB(const CRGB& rgb,int parentIndex, HSLOperation op) override {
                 for(int i=0;i<=m_repeatCount;i++) {
-                    if (tidx+i*m_repeatLength >= m_length) break;
-                    m_parent->setLightness(lightness,tidx+i*m_repeatLength,top);
+                    if (parentIndex+i*m_repeatLength >= m_length) break;
+                    m_parent->setRGB(rgb,parentIndex+i*m_repeatLength,op);
                 }
             }
 
-            void setRGB(const CRGB& rgb,int index, HSLOperation op) override {
-                if (!isPositionValid(index)) { return;}            
-                int tidx = translateIndex(index);
-                HSLOperation top = translateOp(op);
-                for(int i=0;i<=m_repeatCount;i++) {
-                    if (tidx+i*m_repeatLength >= m_length) break;
-                    m_parent->setRGB(rgb,tidx+i*m_repeatLength,top);
-                }                
-            }              
-
-        protected:
             friend class CopyElement;
 
             int m_repeatCount;
@@ -311,6 +443,10 @@ namespace DevRelief
                 return true;
             }
 
+            virtual void afterDrawChildren() {
+                m_copyStrip.flush();
+            }
+
             void valuesToJson(JsonObject* json) const override {
                 StripElement::valuesToJson(json);
                 if (m_countValue) {
@@ -320,6 +456,8 @@ namespace DevRelief
 
             void valuesFromJson(JsonObject* json) override {
                 StripElement::valuesFromJson(json);
+                // fromJson() calls this more than once
+                if (m_countValue) { m_countValue->destroy();}
                 m_countValue = ScriptValue::create(json->getPropertyValue("count"));
 
             }            
@@ -358,6 +496,10 @@ namespace DevRelief
                 m_repeatStrip.setRepeatLength(childrenLength);
                 return true;
             }
+
+            virtual void afterDrawChildren() {
+                m_repeatStrip.flush();
+            }
            
         private:
             RepeatStrip m_repeatStrip;
@@ -0,0 +1,142 @@
+#ifndef ANIMATION_TEST_H
+#define ANIMATION_TEST_H
+
+#include "../lib/test/test_suite.h"
+#include "../lib/util/fixed.h"
+#include "../lib/led/color.h"
+#include "../script/animation.h"
+
+#if RUN_TESTS==1
+namespace DevRelief {
+
+class AnimationTestSuite : public TestSuite{
+    public:
+        static bool Run(ILogger* logger) {
+            AnimationTestSuite test(logger);
+            test.run();
+            return test.isSuccess();
+        }
+
+        void run() {
+            runTest("fixedArithmetic",[&](TestResult&r){fixedArithmetic(r);});
+            runTest("fixedPercent",[&](TestResult&r){fixedPercent(r);});
+            runTest("fixedEase",[&](TestResult&r){fixedEase(r);});
+            runTest("fixedColor",[&](TestResult&r){fixedColor(r);});
+            runTest("easeTables",[&](TestResult&r){easeTables(r);});
+        }
+
+        AnimationTestSuite(ILogger* logger) : TestSuite("Animation Tests",logger){
+
+        }
+
+    protected:
+
+    void fixedArithmetic(TestResult& result);
+    void fixedPercent(TestResult& result);
+    void fixedEase(TestResult& result);
+    void fixedColor(TestResult& result);
+    void easeTables(TestResult& result);
+
+    // difference in millionths
+    int error(Fixed fixed, double expect) {
+        return (int)(fabs((double)fixed - expect)*1000000);
+    }
+};
+
+void AnimationTestSuite::fixedArithmetic(TestResult& result) {
+    result.assertEqual((int)Fixed(12),12,"int");
+    result.assertEqual((int)Fixed(-2.75),-2,"negative truncates toward 0");
+    result.assertEqual(Fixed(0.5).raw(),Fixed::ONE/2,"half");
+    result.assertEqual(error(Fixed(1.25)*Fixed(-3),-3.75),0,"multiply");
+    result.assertEqual(error(Fixed(7)/Fixed(4),1.75),0,"divide");
+    result.assertEqual((int)(Fixed(7)/Fixed(0)),0,"divide by 0");
+    result.assertEqual(error(1-Fixed(0.25)*2,0.5),0,"mixed int");
+    result.assertTrue(Fixed(0.5) < 1 && Fixed(2) > Fixed(1.5),"compare");
+}
+
+void AnimationTestSuite::fixedPercent(TestResult& result) {
+    // domain percents for strips up to 5000 LEDs
+    const int lengths[] = {60,300,1200,5000};
+    int maxError = 0;
+    for(int l=0;l<4;l++) {
+        for(int pos=0;pos<lengths[l];pos++) {
+            double expect = (double)pos/(lengths[l]-1);
+            int e = error(toReal<Fixed>((double)pos,(double)(lengths[l]-1)),expect);
+            if (e > maxError) { maxError = e;}
+        }
+    }
+    result.assertBetween(maxError,0,16,"percent error");
+}
+
+void AnimationTestSuite::fixedEase(TestResult& result) {
+    const double ins[] = {0,0.3,0.5,1};
+    const double outs[] = {0,0.5,0.8,1};
+    int maxError = 0;
+    for(int i=0;i<4;i++) {
+        for(int o=0;o<4;o++) {
+            for(int step=0;step<=1024;step++) {
+                double pos = step/1024.0;
+                double expect = cubicBezier<double>(pos,1-ins[i],outs[o]);
+                int e = error(cubicBezier<Fixed>(Fixed(pos),1-Fixed(ins[i]),Fixed(outs[o])),expect);
+                if (e > maxError) { maxError = e;}
+            }
+        }
+    }
+    result.assertBetween(maxError,0,100,"ease error");
+}
+
+// every hue with saturation and lightness in steps of 5.
+// a color channel may be 1 different from the floating point color
+void AnimationTestSuite::fixedColor(TestResult& result) {
+    int maxError = 0;
+    for(int hue=0;hue<360;hue++) {
+        for(int saturation=0;saturation<=100;saturation+=5) {
+            for(int lightness=0;lightness<=100;lightness+=5) {
+                CHSL hsl(hue,saturation,lightness);
+                CRGB expect = HSLToRGBWith<float>(hsl);
+                CRGB fixed = HSLToRGBWith<Fixed>(hsl);
+                int e = abs(expect.red-fixed.red);
+                if (abs(expect.green-fixed.green) > e) { e = abs(expect.green-fixed.green);}
+                if (abs(expect.blue-fixed.blue) > e) { e = abs(expect.blue-fixed.blue);}
+                if (e > maxError) { maxError = e;}
+            }
+        }
+    }
+    result.assertBetween(maxError,0,1,"color error");
+}
+
+void AnimationTestSuite::easeTables(TestResult& result) {
+    CubicBezierEase bezier(0.3,0.8);
+    int maxError = 0;
+    for(int step=0;step<=1024;step++) {
+        double pos = step/1024.0;
+        int e = (int)(fabs((double)bezier.calculate(Real(pos))-cubicBezier<double>(pos,0.7,0.8))*1000000);
+        if (e > maxError) { maxError = e;}
+    }
+    result.assertBetween(maxError,0,1000,"bezier table error");
+    bezier.setValues(1,0);
+    result.assertEqual((int)((double)bezier.calculate(Real(0.5))*1000+0.5),125,"rebaked");
+
+    const char * names[] = {"sine","expo","bounce","elastic"};
+    for(int i=0;i<4;i++) {
+        int curve = EaseCurves::indexOf(names[i]);
+        result.assertTrue(curve >= 0,names[i]);
+        if (curve < 0) { continue;}
+        NamedEase ease(curve);
+        result.assertEqual((int)((double)ease.calculate(0)*1000),0,"start");
+        result.assertEqual((int)((double)ease.calculate(1)*1000+0.5),1000,"end");
+    }
+    NamedEase sine(EaseCurves::indexOf("sine"));
+    result.assertEqual((int)((double)sine.calculate(Real(0.5))*1000+0.5),500,"sine middle");
+
+    result.assertEqual(EaseCurves::indexOf("unknown"),-1,"unknown curve");
+    result.assertTrue(EaseCurves::add("test-square",[](double position) { return position*position;}),"add curve");
+    result.assertTrue(!EaseCurves::add("test-square",[](double position) { return position;}),"duplicate curve");
+    NamedEase square(EaseCurves::indexOf("test-square"));
+    result.assertEqual((int)((double)square.calculate(Real(0.5))*1000+0.5),250,"custom curve");
+}
+
+}
+#endif
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef COLOR_TEST_H
+#define COLOR_TEST_H
+
+#include "../lib/test/test_suite.h"
+#include "../lib/led/color.h"
+
+#if RUN_TESTS==1
+namespace DevRelief {
+
+class ColorTestSuite : public TestSuite{
+    public:
+        static bool Run(ILogger* logger) {
+            ColorTestSuite test(logger);
+            test.run();
+            return test.isSuccess();
+        }
+
+        void run() {
+            runTest("primaryColors",[&](TestResult&r){primaryColors(r);});
+            runTest("integerHSLToRGB",[&](TestResult&r){integerHSLToRGB(r);});
+            runTest("integerRGBToHSL",[&](TestResult&r){integerRGBToHSL(r);});
+            runTest("outputTransform",[&](TestResult&r){outputTransform(r);});
+        }
+
+        ColorTestSuite(ILogger* logger) : TestSuite("Color Tests",logger){
+
+        }
+
+    protected:
+
+    void primaryColors(TestResult& result);
+    void integerHSLToRGB(TestResult& result);
+    void integerRGBToHSL(TestResult& result);
+    void outputTransform(TestResult& result);
+
+    bool sameRGB(TestResult& result, const CRGB& rgb, int red, int green, int blue, const char * msg) {
+        return result.assertTrue(rgb.red == red && rgb.green == green && rgb.blue == blue,msg);
+    }
+};
+
+void ColorTestSuite::primaryColors(TestResult& result) {
+    sameRGB(result,HSLToRGBInt(CHSL(HUE::RED,100,50)),255,0,0,"red");
+    sameRGB(result,HSLToRGBInt(CHSL(120,100,50)),0,255,0,"green");
+    sameRGB(result,HSLToRGBInt(CHSL(240,100,50)),0,0,255,"blue");
+    sameRGB(result,HSLToRGBInt(CHSL(HUE::YELLOW,100,50)),255,255,0,"yellow");
+    sameRGB(result,HSLToRGBInt(CHSL(0,0,100)),255,255,255,"white");
+    sameRGB(result,HSLToRGBInt(CHSL(HUE::BLUE,100,0)),0,0,0,"black");
+    CHSL hsl = RGBToHSLInt(CRGB(0,0,255));
+    result.assertTrue(hsl.hue == 240 && hsl.saturation == 100 && hsl.lightness == 50,"blue hsl");
+    hsl = RGBToHSLInt(CRGB(255,128,0));
+    result.assertTrue(hsl.hue == 30 && hsl.saturation == 100 && hsl.lightness == 50,"orange hsl");
+}
+
+// every hue, saturation and lightness.  a channel may be 1 different from the float conversion
+void ColorTestSuite::integerHSLToRGB(TestResult& result) {
+    int maxError = 0;
+    for(int hue=0;hue<360;hue++) {
+        for(int saturation=0;saturation<=100;saturation++) {
+            for(int lightness=0;lightness<=100;lightness++) {
+                CHSL hsl(hue,saturation,lightness);
+                CRGB expect = HSLToRGBWith<float>(hsl);
+                CRGB rgb = HSLToRGBInt(hsl);
+                int e = abs(expect.red-rgb.red);
+                if (abs(expect.green-rgb.green) > e) { e = abs(expect.green-rgb.green);}
+                if (abs(expect.blue-rgb.blue) > e) { e = abs(expect.blue-rgb.blue);}
+                if (e > maxError) { maxError = e;}
+            }
+        }
+    }
+    result.assertBetween(maxError,0,1,"HSL to RGB error");
+}
+
+// every third value of each channel (0-255).
+void ColorTestSuite::integerRGBToHSL(TestResult& result) {
+    int maxError = 0;
+    for(int red=0;red<256;red+=3) {
+        for(int green=0;green<256;green+=3) {
+            for(int blue=0;blue<256;blue+=3) {
+                CRGB rgb(red,green,blue);
+                CHSL expect = RGBToHSLFloat(rgb);
+                CHSL hsl = RGBToHSLInt(rgb);
+                int e = abs(expect.hue-hsl.hue);
+                if (abs(expect.saturation-hsl.saturation) > e) { e = abs(expect.saturation-hsl.saturation);}
+                if (abs(expect.lightness-hsl.lightness) > e) { e = abs(expect.lightness-hsl.lightness);}
+                if (e > maxError) { maxError = e;}
+            }
+        }
+    }
+    result.assertBetween(maxError,0,1,"RGB to HSL error");
+}
+
+// without gamma and white balance the tables scale like Adafruit_NeoPixel::setBrightness()
+void ColorTestSuite::outputTransform(TestResult& result) {
+    OutputTransform transform;
+    const int brightness[] = {0,1,40,128,254,255};
+    bool driverScale = true;
+    for(int b=0;b<6;b++) {
+        transform.setBrightness(brightness[b]);
+        uint8_t stored = brightness[b]+1;
+        for(int i=0;i<256;i++) {
+            int expect = stored == 0 ? i : (i*stored) >> 8;
+            driverScale = driverScale && transform.red(i) == expect && transform.green(i) == expect && transform.blue(i) == expect;
+        }
+    }
+    result.assertTrue(driverScale,"brightness");
+
+    transform.setBrightness(255);
+    transform.setGamma(2.2);
+    bool increasing = true;
+    for(int i=1;i<256;i++) {
+        increasing = increasing && transform.red(i) >= transform.red(i-1);
+    }
+    result.assertTrue(increasing,"gamma increases");
+    result.assertEqual(transform.red(0),0,"gamma 0");
+    result.assertEqual(transform.red(255),255,"gamma 255");
+    result.assertEqual(transform.red(128),56,"gamma 128");
+
+    transform.setGamma(1);
+    transform.setWhiteBalance(255,128,0);
+    CRGB color = transform.apply(CRGB(200,200,200));
+    result.assertTrue(color.red == 200 && color.green == 100 && color.blue == 0,"white balance");
+    transform.setBrightness(127);
+    color = transform.apply(CRGB(200,200,200));
+    result.assertTrue(color.red == 100 && color.green == 50 && color.blue == 0,"brightness and white balance");
+}
+
+}
+#endif
+
+#endif
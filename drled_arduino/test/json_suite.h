@@ -26,6 +26,20 @@ namespace DevRelief
             }        
         )script";
 
+        const char *DUPLICATE_NAME_SCRIPT = R"script(
+            {
+                "name": "first",
+                "name": "second"
+            }        
+        )script";
+
+        const char *ESCAPED_SCRIPT = R"script(
+            {
+                "name": "say \"hi\"\n",
+                "path\\": "a\/b\u00e9"
+            }        
+        )script";
+
   
     class JsonTestSuite : public TestSuite
     {
@@ -54,6 +68,10 @@ namespace DevRelief
                     { testParseArray(r); });
             runTest("testGenerateSimple", [&](TestResult &r)
                     { testGenerateSimple(r); });
+            runTest("testRootArena", [&](TestResult &r)
+                    { testRootArena(r); });
+            runTest("testParseInPlace", [&](TestResult &r)
+                    { testParseInPlace(r); });
  
                                   
         }
@@ -67,6 +85,8 @@ namespace DevRelief
         void testParseSimple(TestResult &result);
         void testParseArray(TestResult &result);
         void testGenerateSimple(TestResult &result);
+        void testRootArena(TestResult &result);
+        void testParseInPlace(TestResult &result);
         //void testJsonValue(TestResult &result);
         //void testPosition(TestResult &result);
     };
@@ -133,6 +153,62 @@ namespace DevRelief
         m_logger->showMemory();
     }
 
+    void JsonTestSuite::testRootArena(TestResult &result)
+    {
+        LogIndent li(m_logger,"testRootArena");
+        JsonParser parser;
+#ifdef FAKE_ARDUINO
+        size_t allocs = EspBoard.getAllocationCount();
+#endif
+        JsonRoot* root = parser.read(ARRAY_SCRIPT);
+#ifdef FAKE_ARDUINO
+        result.assertBetween((int)(EspBoard.getAllocationCount()-allocs),1,6,"elements are not allocated one at a time");
+#endif
+        JsonObject* obj = root->getTopObject();
+        result.assertEqual(root->getArena().getChunkCount(),1,"reserved chunk holds the script");
+        result.assertTrue(root->ownsMemory(obj),"object is in the root arena");
+        result.assertTrue(root->ownsMemory(obj->getString("name",NULL)),"string is in the root arena");
+
+        // elements from another root's arena are copied since that memory is freed with the root
+        JsonRoot other;
+        other.getTopObject()->set("script",obj);
+        root->destroy();
+        JsonObject* script = other.getTopObject()->getChild("script");
+        result.assertNotNull(script,"copied object");
+        result.assertEqual(script->getString("name",NULL),"with elements array","copied string");
+        JsonArray* elements = script->getArray("elements");
+        result.assertNotNull(elements,"copied array");
+        result.assertEqual(elements ? elements->getCount() : 0,1,"copied array items");
+
+        root = parser.read(DUPLICATE_NAME_SCRIPT);
+        result.assertEqual(root->getTopObject()->getString("name",NULL),"second","duplicate name replaces value");
+        root->destroy();
+    }
+
+    void JsonTestSuite::testParseInPlace(TestResult &result)
+    {
+        LogIndent li(m_logger,"testParseInPlace");
+        JsonParser parser;
+        DRString text(ESCAPED_SCRIPT);
+        JsonRoot* root = parser.readInPlace((char*)text.text());
+        JsonObject* obj = root->getTopObject();
+        const char * name = obj->getString("name",NULL);
+        result.assertEqual(name,"say \"hi\"\n","unescaped in place");
+        result.assertTrue(name >= text.text() && name < text.text()+text.getLength(),"string points into source text");
+        result.assertFalse(root->ownsMemory(name),"string is not copied to the arena");
+        result.assertEqual(obj->getString("path\\",NULL),"a/b\xc3\xa9","unescaped name and \\u");
+
+        // the generator escapes the text again so it parses to the same values
+        DRString generated = root->toString();
+        root->destroy();
+        root = parser.read(generated.text());
+        obj = root->getTopObject();
+        result.assertEqual(obj->getString("name",NULL),"say \"hi\"\n","copied string is unescaped");
+        result.assertEqual(obj->getString("path\\",NULL),"a/b\xc3\xa9","copied name is unescaped");
+        result.assertTrue(root->ownsMemory(obj->getString("name",NULL)),"copied string is in the arena");
+        root->destroy();
+    }
+
 }
 #endif
 
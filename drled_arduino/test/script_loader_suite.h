@@ -21,6 +21,29 @@ const char *LOAD_SIMPLE_SCRIPT = R"script(
         }        
     )script";    
 
+// "elements" is not the first property so the scanner has to come back for it
+const char *LOAD_NESTED_SCRIPT = R"script(
+        {
+            "elements": [
+                { "type": "values", "level": 40 },
+                {
+                    "elements": [
+                        { "type": "hsl", "hue": 50, "lightness": "var(level)" },
+                        { "type": "segment", "offset": 2, "elements": [
+                            { "hue": 200, "name": "a \"quoted\" [name]" }
+                        ]}
+                    ],
+                    "type": "segment",
+                    "length": 10
+                },
+                { "type": "mirror", "elements": [] }
+            ],
+            "name": "nested \"load\"",
+            "rotate": 3,
+            "frequency": 20
+        }
+    )script";
+
 
 class ScriptLoaderTestSuite : public TestSuite{
     public:
@@ -35,6 +58,7 @@ class ScriptLoaderTestSuite : public TestSuite{
             runTest("testScriptCommandMemLeak",[&](TestResult&r){memLeakScriptCommand(r);});
             runTest("testScriptTextToJsonLoaderMemLeak",[&](TestResult&r){testScriptTextToJsonLoaderMemLeak(r);});
             runTest("testScriptLoaderMemLeak",[&](TestResult&r){memLeak(r);});
+            runTest("testStreamLoad",[&](TestResult&r){streamLoad(r);});
         }
 
         ScriptLoaderTestSuite(ILogger* logger) : TestSuite("ScriptLoader Tests",logger){
@@ -46,6 +70,7 @@ class ScriptLoaderTestSuite : public TestSuite{
     void memLeakScriptCommand(TestResult& result);
     void testScriptTextToJsonLoaderMemLeak(TestResult& result);
     void memLeak(TestResult& result);
+    void streamLoad(TestResult& result);
 };
 
 void ScriptLoaderTestSuite::memLeakScriptCommand(TestResult& result) {
@@ -95,6 +120,39 @@ void ScriptLoaderTestSuite::memLeak(TestResult& result) {
 
 }
 
+void ScriptLoaderTestSuite::streamLoad(TestResult& result) {
+    ScriptDataLoader loader;
+    loader.save("test_stream",LOAD_NESTED_SCRIPT);
+    Script* loaded = loader.load("test_stream");
+    loader.deleteScript("test_stream");
+    Script* parsed = loader.parse(LOAD_NESTED_SCRIPT);
+    result.assertNotNull(loaded,"script loaded from file");
+    result.assertNotNull(parsed,"script parsed from text");
+    if (loaded == NULL || parsed == NULL) {
+        if (loaded) { loaded->destroy();}
+        if (parsed) { parsed->destroy();}
+        return;
+    }
+    result.assertEqual(loaded->getName(),"nested \"load\"","name");
+    result.assertEqual(loaded->getFrequency(),20,"frequency after elements");
+    // the same objects are created when the json is read one element at a time
+    result.assertEqual((int)loaded->getArena()->getUsed(),(int)parsed->getArena()->getUsed(),"same arena use");
+    result.assertEqual(loaded->getArena()->getChunkCount(),1,"arena estimated from the file");
+
+    const PtrList<IScriptElement*>& children = loaded->getRootContainer()->getChildren();
+    result.assertEqual(children.size(),3,"top elements");
+    IScriptElement* segment = children.get(1);
+    result.assertTrue(segment && segment->isContainer(),"segment type from json after elements");
+    if (segment && segment->isContainer()) {
+        ScriptContainer* container = (ScriptContainer*)segment;
+        result.assertEqual(container->getChildren().size(),2,"segment children");
+        IScriptElement* nested = container->getChildren().get(1);
+        result.assertEqual(nested->isContainer() ? ((ScriptContainer*)nested)->getChildren().size() : 0,1,"nested segment children");
+    }
+    loaded->destroy();
+    parsed->destroy();
+}
+
 
 
 
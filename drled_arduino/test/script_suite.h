@@ -29,6 +29,166 @@ class DummyStrip : public HSLFilter {
         int getPixelsPerMeter() override { return 30;}
 };
 
+// keeps the colors from HSLStrip::show() so tests can compare them
+class CaptureStrip : public DRLedStrip {
+    public:
+        CaptureStrip(int count) : DRLedStrip(30) { 
+            m_count = count;
+            m_colors = new CRGB[count];
+            m_setCount = 0;
+            m_showCount = 0;
+        }
+        virtual ~CaptureStrip() { delete [] m_colors;}
+
+        void clear() override {}
+        void setBrightness(uint16_t brightness) override {}
+        void setColor(uint32_t index, const CRGB& color) override { m_setCount++; if (index < m_count) { m_colors[index] = color;}}
+        int getLEDCount() override { return m_count;}
+        void show() override { m_showCount++;}
+
+        // number of setColor() and show() calls since the last reset
+        int getSetCount() const { return m_setCount;}
+        int getShowCount() const { return m_showCount;}
+        void resetCounts() { m_setCount = 0; m_showCount = 0;}
+        const CRGB& getColor(int index) const { return m_colors[index];}
+        CompoundLedStrip* getCompoundLedStrip() override { return NULL;}
+
+        bool equals(const CaptureStrip* other) const {
+            for(int i=0;i<m_count;i++) {
+                const CRGB& a = m_colors[i];
+                const CRGB& b = other->m_colors[i];
+                if (a.red != b.red || a.green != b.green || a.blue != b.blue) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    private:
+        int m_count;
+        CRGB* m_colors;
+        int m_setCount;
+        int m_showCount;
+};
+
+// gives tests the driver of a physical strip
+class DriverStrip : public PhyisicalLedStrip {
+    public:
+        DriverStrip(int pin, int count, neoPixelType pixelType) : PhyisicalLedStrip(pin,count,30,pixelType,255) {}
+        Adafruit_NeoPixel* getController() { return m_controller;}
+
+        // estimated current of the driver bytes at 20mA per channel
+        int getMilliamps() {
+            int total = 0;
+            for(int i=0;i<m_controller->numPixels();i++) {
+                uint32_t color = m_controller->getPixelColor(i);
+                total += ((color >> 16) & 0xff) + ((color >> 8) & 0xff) + (color & 0xff);
+            }
+            return total*20/255;
+        }
+};
+
+// %s is the hue.  segments, mirror, copy and repeat all pass span writes to their parent
+const char * SPAN_SCRIPT = R"script(
+        {
+            "name": "spans",
+            "frequency": 0,
+            "elements": [
+            { "type": "hsl", "hue": %s, "lightness": 30 },
+            { "type": "hsl", "unit": "pixel", "offset": -5, "length": 20, "hue": %s, "op": "add" },
+            { "type": "hsl", "unit": "pixel", "offset": 50, "length": 30, "reverse": true, "hue": %s, "op": "average" },
+            { "type": "hsl", "unit": "pixel", "offset": 90, "length": 20, "wrap": true, "hue": %s, "op": "max" },
+            { "type": "mirror", "elements": [{ "type": "hsl", "unit": "percent", "offset": 10, "length": 30, "hue": %s, "op": "average" }]},
+            { "type": "copy", "count": 3, "elements": [{ "type": "hsl", "length": 40, "hue": %s, "op": "add" }]},
+            { "type": "repeat", "elements": [{ "type": "hsl", "length": 7, "hue": %s, "op": "average" }]}
+            ]
+        }        
+    )script";
+
+// %s is the hue of the LEDs.  the nested segments put them at 49-52 in reverse order
+const char * NESTED_MAP_SCRIPT = R"script(
+        {
+            "name": "nested",
+            "frequency": 0,
+            "elements": [
+            { "type": "segment", "unit": "pixel", "offset": 10, "length": 50, "reverse": true, "elements": [
+                { "type": "segment", "unit": "pixel", "offset": 5, "length": 20, "elements": [
+                    { "type": "hsl", "unit": "pixel", "offset": 2, "length": 4, "hue": %s, "lightness": 40 }
+                ]}
+            ]}
+            ]
+        }        
+    )script";
+
+const char * FLAT_MAP_SCRIPT = R"script(
+        {
+            "name": "flat",
+            "frequency": 0,
+            "elements": [
+            { "type": "hsl", "unit": "pixel", "offset": 49, "length": 4, "reverse": true, "hue": %s, "lightness": 40 }
+            ]
+        }        
+    )script";
+
+// %s is a copy of two layered children.  the second child flows after the first
+const char * COPY_SCRIPT = R"script(
+        {
+            "name": "copy",
+            "frequency": 0,
+            "elements": [
+            { "type": "copy", "count": 3, "elements": [ %s ]}
+            ]
+        }        
+    )script";
+
+// %s is three segments with the same children as COPY_SCRIPT
+const char * FLAT_COPY_SCRIPT = R"script(
+        {
+            "name": "flat",
+            "frequency": 0,
+            "elements": [
+            { "type": "segment", "unit": "pixel", "length": 40, "elements": [ %s ]},
+            { "type": "segment", "unit": "pixel", "length": 40, "elements": [ %s ]},
+            { "type": "segment", "unit": "pixel", "length": 40, "elements": [ %s ]}
+            ]
+        }        
+    )script";
+
+const char * LAYERED_CHILDREN = R"json(
+    { "type": "hsl", "unit": "pixel", "length": 20, "hue": 100, "lightness": 40 },
+    { "type": "hsl", "unit": "pixel", "offset": -15, "length": 20, "hue": 30, "op": "add" }
+)json";
+
+// %s is the rotation of three LEDs drawn at the start of the strip
+const char * ROTATE_SCRIPT = R"script(
+        {
+            "name": "rotate",
+            "frequency": 0,
+            "rotate": %s,
+            "elements": [
+            { "type": "hsl", "unit": "pixel", "length": 3, "hue": 200 }
+            ]
+        }        
+    )script";
+
+// timer and values elements set context values on every frame
+const char * FRAME_VALUES_SCRIPT = R"script(
+        {
+            "name": "frame values",
+            "frequency": 0,
+            "elements": [
+            { "type": "values", "baseHue": ["+","sys(step)",3], "light": {"range":[10,90],"duration":50,"repeat":true} },
+            { "type": "hsl", "hue": ["+","var(baseHue)","var(shift)|0"], "lightness": "var(light)", "length": ["+","var(len)",5],
+              "timer": {
+                "run": { "duration": 10, "enter": { "shift": ["+","var(shift)|0",50], "len": 1 }, "step": { "len": ["+","var(len)",1] } },
+                "pause": { "duration": 10, "leave": { "len": 0 } },
+                "repeat": 0
+              }
+            },
+            { "type": "rgb", "red": ["%","sys(step)",255], "blue": "var(missing)|20" }
+            ]
+        }        
+    )script";
+
 class ScriptTestSuite : public TestSuite{
     public:
 
@@ -40,6 +200,25 @@ class ScriptTestSuite : public TestSuite{
 
         void run() {
             runTest("scriptLifecycle",[&](TestResult&r){scriptLifecycle(r);});
+            runTest("functionProgram",[&](TestResult&r){functionProgram(r);});
+            runTest("variableSymbols",[&](TestResult&r){variableSymbols(r);});
+            runTest("valueDependence",[&](TestResult&r){valueDependence(r);});
+            runTest("hslSpans",[&](TestResult&r){hslSpans(r);});
+            runTest("dirtyRanges",[&](TestResult&r){dirtyRanges(r);});
+            runTest("clearGenerations",[&](TestResult&r){clearGenerations(r);});
+            runTest("directOutput",[&](TestResult&r){directOutput(r);});
+            runTest("powerLimit",[&](TestResult&r){powerLimit(r);});
+            runTest("compoundStrips",[&](TestResult&r){compoundStrips(r);});
+            runTest("indexMaps",[&](TestResult&r){indexMaps(r);});
+            runTest("bufferedCopies",[&](TestResult&r){bufferedCopies(r);});
+            runTest("rotation",[&](TestResult&r){rotation(r);});
+            runTest("rangeValues",[&](TestResult&r){rangeValues(r);});
+            runTest("patternSegments",[&](TestResult&r){patternSegments(r);});
+            runTest("scriptArena",[&](TestResult&r){scriptArena(r);});
+#ifdef FAKE_ARDUINO
+            // only the host board counts allocations
+            runTest("frameAllocations",[&](TestResult&r){frameAllocations(r);});
+#endif
         }
 
         ScriptTestSuite(ILogger* logger) : TestSuite("Script Tests",logger){
@@ -50,6 +229,79 @@ class ScriptTestSuite : public TestSuite{
 
 
     void scriptLifecycle(TestResult& result);
+    void functionProgram(TestResult& result);
+    void variableSymbols(TestResult& result);
+    void valueDependence(TestResult& result);
+    void hslSpans(TestResult& result);
+    void dirtyRanges(TestResult& result);
+    void clearGenerations(TestResult& result);
+    void directOutput(TestResult& result);
+    void powerLimit(TestResult& result);
+    void compoundStrips(TestResult& result);
+    void indexMaps(TestResult& result);
+    void bufferedCopies(TestResult& result);
+    void rotation(TestResult& result);
+    void rangeValues(TestResult& result);
+    void patternSegments(TestResult& result);
+    void scriptArena(TestResult& result);
+    void frameAllocations(TestResult& result);
+
+    IScriptValue* createValue(const char * json) {
+        JsonParser parser;
+        JsonRoot* root = parser.read(json);
+        IScriptValue* value = ScriptValue::create(root->getTopElement());
+        root->destroy();
+        return value;
+    }
+
+    // evaluates twice so the result of compiling is checked.
+    int evaluate(const char * json, double defaultValue=0, IScriptContext* ctx=NULL) {
+        IScriptValue* value = createValue(json);
+        value->getFloatValue(ctx,defaultValue);
+        int result = value->getFloatValue(ctx,defaultValue);
+        value->destroy();
+        return result;
+    }
+
+    // draws SPAN_SCRIPT with every hue set to "hue"
+    void drawSpanScript(const char * hue, HSLStrip* strip) {
+        char text[1500];
+        snprintf(text,sizeof(text),SPAN_SCRIPT,hue,hue,hue,hue,hue,hue,hue);
+        drawScript(text,strip);
+    }
+
+    // draws one step of the script
+    void drawScript(const char * text, HSLStrip* strip) {
+        ScriptDataLoader loader;
+        Script* script = loader.parse(text);
+        script->begin(strip,NULL);
+        script->step();
+        script->destroy();
+    }
+
+    // true if getFloatValues() matches getFloatValue() at each LED position
+    bool rangeMatches(const char * json, IScriptContext* ctx, int first, int count) {
+        IScriptValue* value = createValue(json);
+        PositionDomain* domain = ctx->getAnimationPositionDomain();
+        double values[SCRIPT_VALUE_CHUNK];
+        value->getFloatValues(ctx,first,count,-1,values);
+        bool match = true;
+        for(int i=0;i<count;i++) {
+            domain->setPos(first+i);
+            if (value->getFloatValue(ctx,-1) != values[i]) {
+                match = false;
+            }
+        }
+        value->destroy();
+        return match;
+    }
+
+    ValueDependence dependence(const char * json, IScriptContext* ctx=NULL) {
+        IScriptValue* value = createValue(json);
+        ValueDependence result = value->getDependence(ctx);
+        value->destroy();
+        return result;
+    }
 };
 
 
@@ -81,6 +333,507 @@ void ScriptTestSuite::scriptLifecycle(TestResult& result) {
     m_logger->showMemory();
 }
 
+void ScriptTestSuite::functionProgram(TestResult& result) {
+    result.assertEqual(evaluate(R"(["+",1,2])"),3,"add");
+    result.assertEqual(evaluate(R"(["*",["+",1,2],["-",10,4]])"),18,"nested");
+    result.assertEqual(evaluate(R"(["-",5])"),-5,"negate");
+    result.assertEqual(evaluate(R"(["/",1,0])"),0,"divide by 0");
+    result.assertEqual(evaluate(R"(["%",7,3])"),1,"mod");
+    result.assertEqual(evaluate(R"(["%",7,0])"),0,"mod 0");
+    result.assertEqual(evaluate(R"(["min",["max",3,9],5])"),5,"min max");
+    result.assertEqual(evaluate(R"(["+"])",4),8,"missing args use default");
+    result.assertEqual(evaluate(R"(["+",1,null])",4),5,"null arg uses default");
+    result.assertBetween(evaluate(R"(["rand",5,5])"),0,5,"rand");
+    result.assertBetween(evaluate(R"(["rand",["+",10,0]])"),0,10,"rand one arg");
+
+    IScriptValue* seq = createValue(R"(["seq",0,2])");
+    result.assertEqual(seq->getIntValue(NULL,0),0,"seq 0");
+    result.assertEqual(seq->getIntValue(NULL,0),1,"seq 1");
+    result.assertEqual(seq->getIntValue(NULL,0),2,"seq 2");
+    result.assertEqual(seq->getIntValue(NULL,0),0,"seq wraps");
+    seq->destroy();
+
+    IScriptValue* randOf = createValue(R"(["randOf",1,["+",1,1],3])");
+    for(int i=0;i<20;i++) {
+        result.assertBetween(randOf->getIntValue(NULL,0),1,3,"randOf");
+    }
+    randOf->destroy();
+
+    // too deep for the program stack.  falls back to invoke()
+    result.assertEqual(evaluate(R"(["+",1,["+",1,["+",1,["+",1,["+",1,["+",1,["+",1,["+",1,["+",1,["+",1,
+        ["+",1,["+",1,["+",1,["+",1,["+",1,["+",1,["+",1,["+",1,["+",1,["+",1,0]]]]]]]]]]]]]]]]]]]])"),20,"deep");
+}
+
+void ScriptTestSuite::variableSymbols(TestResult& result) {
+    ScriptSymbol a = ScriptSymbols::intern("symbolTestA");
+    result.assertNotEqual(a,SYMBOL_NONE,"interned");
+    result.assertEqual(ScriptSymbols::intern("symbolTestA"),a,"same symbol");
+    result.assertEqual(ScriptSymbols::find("symbolTestA"),a,"find");
+    result.assertEqual(ScriptSymbols::getName(a),"symbolTestA","name");
+
+    RootContext root;
+    root.setParams(NULL);
+    root.setValue("symbolTestA",new ScriptNumberValue(5));
+    ChildContext child(&root);
+    child.setValue("symbolTestB",new ScriptNumberValue(3));
+    result.assertEqual(evaluate(R"json(["+","var(symbolTestA)","var(symbolTestB)"])json",0,&child),8,"parent and child values");
+    child.setValue("symbolTestA",new ScriptNumberValue(10));
+    result.assertEqual(evaluate(R"json("var(symbolTestA)")json",0,&child),10,"child replaces parent");
+    child.setValue("symbolTestA",new ScriptNumberValue(12));
+    result.assertEqual(evaluate(R"json("var(symbolTestA)")json",0,&child),12,"replaced value");
+    result.assertEqual(evaluate(R"json("var(symbolTestC)|7")json",0,&child),7,"missing uses default");
+    result.assertEqual(evaluate(R"json("sys(red)")json",0,&child),HUE::RED,"sys value");
+}
+
+void ScriptTestSuite::valueDependence(TestResult& result) {
+    result.assertEqual(dependence("10"),VALUE_CONSTANT,"number");
+    result.assertEqual(dependence(R"json(["+",1,["*",2,3]])json"),VALUE_CONSTANT,"function of constants");
+    result.assertEqual(dependence(R"json(["rand",0,10])json"),VALUE_PER_LED,"rand");
+    result.assertEqual(dependence(R"json(["seq",0,10])json"),VALUE_PER_LED,"seq");
+    result.assertEqual(dependence(R"json("sys(led)")json"),VALUE_PER_LED,"sys(led)");
+    result.assertEqual(dependence(R"json(["+","sys(step)",1])json"),VALUE_PER_FRAME,"sys(step)");
+    result.assertEqual(dependence(R"json({"range":[0,360]})json"),VALUE_PER_LED,"position range");
+    result.assertEqual(dependence(R"json({"range":[0,360],"duration":1000})json"),VALUE_PER_FRAME,"time range");
+    result.assertEqual(dependence(R"json({"range":[0,360],"speed":10})json"),VALUE_PER_FRAME,"speed range");
+
+    RootContext root;
+    root.setParams(NULL);
+    root.setValue("dependConst",new ScriptNumberValue(5));
+    root.setValue("dependRand",createValue(R"json(["rand",0,10])json"));
+    result.assertEqual(dependence(R"json("var(dependConst)")json",&root),VALUE_CONSTANT,"constant variable");
+    result.assertEqual(dependence(R"json(["+","var(dependRand)",1])json",&root),VALUE_PER_LED,"rand variable");
+    result.assertEqual(dependence(R"json("var(dependMissing)|3")json",&root),VALUE_CONSTANT,"variable default");
+    result.assertEqual(dependence(R"json("var(dependConst)")json"),VALUE_PER_LED,"variable without context");
+}
+
+void ScriptTestSuite::hslSpans(TestResult& result) {
+    CaptureStrip* eachCapture = new CaptureStrip(120);
+    CaptureStrip* spanCapture = new CaptureStrip(120);
+    HSLStrip eachStrip(eachCapture);
+    HSLStrip spanStrip(spanCapture);
+
+    eachStrip.clear();
+    spanStrip.clear();
+    int16_t hues[10];
+    int16_t lightness[10];
+    for(int i=0;i<120;i++) {
+        eachStrip.setHue(i,100);
+        eachStrip.setSaturation(i,80);
+        eachStrip.setLightness(i,40);
+        if (i >= 20 && i < 30) {
+            // saturation is not in the span so it is unchanged
+            hues[i-20] = i*3;
+            lightness[i-20] = 60;
+            eachStrip.setHue(i,i*3,AVERAGE);
+            eachStrip.setLightness(i,60,AVERAGE);
+        }
+    }
+    eachStrip.setLightness(5,10);
+    spanStrip.fillHSL(-10,200,100,80,40);
+    spanStrip.writeHSL(20,10,HSLSpan(hues,NULL,lightness),AVERAGE);
+    spanStrip.setHSL(5,HSL_UNSET,HSL_UNSET,10);
+    eachStrip.show();
+    spanStrip.show();
+    result.assertTrue(eachCapture->equals(spanCapture),"HSLStrip spans");
+
+    // a hue that uses sys(led) is drawn one LED at a time.  a constant hue is drawn with span writes
+    eachStrip.clear();
+    spanStrip.clear();
+    drawSpanScript(R"json(["+",120,["*","sys(led)",0]])json",&eachStrip);
+    drawSpanScript("120",&spanStrip);
+    eachStrip.show();
+    spanStrip.show();
+    result.assertTrue(eachCapture->equals(spanCapture),"script spans");
+}
+
+void ScriptTestSuite::dirtyRanges(TestResult& result) {
+    CaptureStrip* first = new CaptureStrip(60);
+    CaptureStrip* second = new CaptureStrip(60);
+    CompoundLedStrip* compound = new CompoundLedStrip(30);
+    compound->add(first);
+    compound->add(second);
+    HSLStrip strip(compound);
+
+    strip.clear();
+    strip.fillHSL(0,120,200,100,50);
+    strip.show();
+    result.assertEqual(first->getSetCount()+second->getSetCount(),120,"first show sets every LED");
+    result.assertEqual(first->getShowCount()+second->getShowCount(),2,"first show");
+
+    first->resetCounts();
+    second->resetCounts();
+    strip.clear();
+    strip.fillHSL(0,120,200,100,50);
+    strip.show();
+    result.assertEqual(first->getSetCount()+second->getSetCount(),0,"unchanged frame sets no LEDs");
+    result.assertEqual(first->getShowCount()+second->getShowCount(),0,"unchanged frame is not shown");
+
+    strip.clear();
+    strip.fillHSL(0,120,200,100,50);
+    strip.setHSL(70,100,100,50);
+    strip.setHSL(75,100,100,50);
+    strip.show();
+    result.assertEqual(second->getSetCount(),2,"changed LEDs are set");
+    result.assertEqual(first->getSetCount(),0,"unchanged strip LEDs");
+    result.assertEqual(second->getShowCount(),1,"changed strip is shown");
+    result.assertEqual(first->getShowCount(),0,"unchanged strip is not shown");
+
+    first->resetCounts();
+    second->resetCounts();
+    strip.clear();
+    strip.fillHSL(0,120,200,100,50);
+    strip.setHSL(70,100,100,50);
+    strip.setHSL(75,100,100,50);
+    strip.setBrightness(20);
+    strip.show();
+    result.assertEqual(first->getSetCount()+second->getSetCount(),120,"brightness converts every LED");
+    result.assertEqual(first->getShowCount()+second->getShowCount(),2,"brightness shows all strips");
+}
+
+void ScriptTestSuite::clearGenerations(TestResult& result) {
+    CaptureStrip* capture = new CaptureStrip(10);
+    HSLStrip strip(capture);
+    CRGB red = HSLToRGB(CHSL(0,100,50));
+    CRGB green = HSLToRGB(CHSL(120,100,50));
+
+    // more clears than generations so the counter wraps.  LED 9 is only written in the first frame
+    bool addReplaced = true;
+    bool othersUnset = true;
+    for(int frame=0;frame<600;frame++) {
+        strip.clear();
+        if (frame == 0) {
+            strip.fillHSL(0,10,120,100,50);
+        } else {
+            // ADD to an LED that is unset in this frame replaces it
+            strip.setHSL(frame%9,0,100,50,ADD);
+        }
+        strip.show();
+        for(int i=0;i<10;i++) {
+            const CRGB& color = capture->getColor(i);
+            const CRGB& expect = frame == 0 ? green : (i == frame%9 ? red : CRGB(0,0,0));
+            bool same = color.red == expect.red && color.green == expect.green && color.blue == expect.blue;
+            if (i == frame%9) {
+                addReplaced = addReplaced && same;
+            } else {
+                othersUnset = othersUnset && same;
+            }
+        }
+    }
+    result.assertTrue(addReplaced,"first write in a frame replaces");
+    result.assertTrue(othersUnset,"LEDs from earlier frames are unset");
+
+    strip.clear();
+    strip.setSaturation(3,0);
+    strip.setLightness(3,100);
+    strip.show();
+    const CRGB& black = capture->getColor(3);
+    result.assertTrue(black.red == 0 && black.green == 0 && black.blue == 0,"no hue is black");
+}
+
+void ScriptTestSuite::directOutput(TestResult& result) {
+    // the same strips with and without direct output.  AlteredStrip hides the driver buffers
+    DriverStrip* drivers[2][3];
+    HSLStrip* strips[2];
+    for(int s=0;s<2;s++) {
+        CompoundLedStrip* compound = new CompoundLedStrip(30);
+        drivers[s][0] = new DriverStrip(1,20,NEO_GRB);
+        drivers[s][1] = new DriverStrip(2,15,NEO_RGB);
+        drivers[s][2] = new DriverStrip(3,25,NEO_GRBW);
+        compound->add(drivers[s][0]);
+        compound->add(new ReverseStrip(drivers[s][1]));
+        compound->add(drivers[s][2]);
+        strips[s] = s == 0 ? new HSLStrip(compound) : new HSLStrip(new AlteredStrip(compound));
+        strips[s]->setBrightness(40);
+    }
+    for(int frame=0;frame<3;frame++) {
+        for(int s=0;s<2;s++) {
+            strips[s]->clear();
+            for(int i=0;i<60;i++) {
+                strips[s]->setHSL(i,(i*37+frame*50)%360,(i*7)%101,(i*13+frame)%101);
+            }
+            if (frame == 2) {
+                strips[s]->setBrightness(90);
+            }
+            strips[s]->show();
+        }
+        for(int d=0;d<3;d++) {
+            Adafruit_NeoPixel* direct = drivers[0][d]->getController();
+            Adafruit_NeoPixel* each = drivers[1][d]->getController();
+            bool same = true;
+            for(int i=0;i<direct->numPixels();i++) {
+                same = same && direct->getPixelColor(i) == each->getPixelColor(i);
+            }
+            result.assertTrue(same,"direct output matches setColor()");
+        }
+    }
+    result.assertTrue(strips[0]->isDirectOutput(),"direct output");
+    result.assertFalse(strips[1]->isDirectOutput(),"setColor() output");
+    delete strips[0];
+    delete strips[1];
+}
+
+void ScriptTestSuite::powerLimit(TestResult& result) {
+    CompoundLedStrip* compound = new CompoundLedStrip(30);
+    DriverStrip* first = new DriverStrip(1,10,NEO_GRB);
+    DriverStrip* second = new DriverStrip(2,10,NEO_GRB);
+    second->setPowerLimit(200);
+    compound->add(first);
+    compound->add(new ReverseStrip(second));
+    HSLStrip strip(compound);
+    strip.setBrightness(255);
+    strip.setPowerLimit(600,20);
+
+    // white is 60mA per LED.  1200mA without limits
+    strip.clear();
+    strip.fillHSL(0,20,0,0,100);
+    strip.show();
+    result.assertBetween(first->getMilliamps(),250,300,"total limit");
+    result.assertBetween(second->getMilliamps(),150,200,"strip limit");
+
+    // below the limits.  every LED is written again without scaling
+    strip.clear();
+    strip.fillHSL(0,20,0,0,10);
+    strip.setHSL(3,0,0,15);
+    strip.show();
+    CRGB dim = HSLToRGB(CHSL(0,0,10));
+    CRGB brighter = HSLToRGB(CHSL(0,0,15));
+    result.assertEqual(first->getController()->getPixelColor(0),Adafruit_NeoPixel::Color(dim.red,dim.green,dim.blue),"not limited");
+    result.assertEqual(first->getController()->getPixelColor(3),Adafruit_NeoPixel::Color(brighter.red,brighter.green,brighter.blue),"changed LED");
+    result.assertEqual(second->getController()->getPixelColor(9),Adafruit_NeoPixel::Color(dim.red,dim.green,dim.blue),"second strip not limited");
+    int milliamps = (dim.red*3*19+brighter.red*3)*20/255;
+    // each strip's current is rounded down
+    result.assertBetween(first->getMilliamps()+second->getMilliamps(),milliamps-1,milliamps,"unlimited current");
+}
+
+void ScriptTestSuite::compoundStrips(TestResult& result) {
+    // more than 4 strips and more than 65535 LEDs
+    const int counts[] = {10,0,25,40000,30000,7};
+    CaptureStrip* captures[6];
+    CompoundLedStrip* compound = new CompoundLedStrip(30);
+    for(int i=0;i<6;i++) {
+        captures[i] = new CaptureStrip(counts[i]);
+        compound->add(captures[i]);
+    }
+    result.assertEqual(compound->getStripCount(),6,"strip count");
+    result.assertEqual(compound->getLEDCount(),70042,"LED count");
+
+    // out of order so the last strip found is not always used
+    const uint32_t indexes[] = {70041,0,9,10,34,35,40034,40035,70034,70035,12};
+    const int strips[] = {5,0,0,2,2,3,3,4,4,5,2};
+    const int positions[] = {6,0,9,0,24,0,39999,0,29999,0,2};
+    bool found = true;
+    for(int i=0;i<11;i++) {
+        compound->setColor(indexes[i],CRGB(i+1,0,0));
+        found = found && captures[strips[i]]->getColor(positions[i]).red == i+1;
+    }
+    result.assertTrue(found,"owning strip");
+    compound->setColor(70042,CRGB(1,1,1));
+    result.assertEqual(captures[5]->getSetCount(),2,"index past the end");
+
+    for(int i=0;i<6;i++) { captures[i]->resetCounts();}
+    compound->showRange(20,40100);
+    result.assertEqual(captures[0]->getShowCount(),0,"before range");
+    result.assertEqual(captures[2]->getShowCount()+captures[3]->getShowCount()+captures[4]->getShowCount(),3,"in range");
+    result.assertEqual(captures[5]->getShowCount(),0,"after range");
+
+    HSLStrip strip(compound);
+    strip.clear();
+    strip.fillHSL(0,70042,HUE::BLUE,100,50);
+    strip.setHSL(70041,HUE::RED,100,50);
+    strip.show();
+    CRGB blue = HSLToRGB(CHSL(HUE::BLUE,100,50));
+    CRGB red = HSLToRGB(CHSL(HUE::RED,100,50));
+    result.assertEqual(captures[4]->getColor(29999).blue,blue.blue,"LED 70034");
+    result.assertEqual(captures[5]->getColor(6).red,red.red,"LED 70041");
+}
+
+void ScriptTestSuite::indexMaps(TestResult& result) {
+    CaptureStrip* reversed = new CaptureStrip(10);
+    CaptureStrip* rotated = new CaptureStrip(10);
+    ReverseStrip reverse(reversed);
+    RotatedStrip rotate(rotated);
+    rotate.setRotation(-12);
+    for(int i=0;i<10;i++) {
+        reverse.setColor(i,CRGB(i,0,0));
+        rotate.setColor(i,CRGB(i,0,0));
+    }
+    bool same = true;
+    for(int i=0;i<10;i++) {
+        same = same && reversed->getColor(9-i).red == i && rotated->getColor((i+8)%10).red == i;
+    }
+    result.assertTrue(same,"reverse and rotation maps");
+
+    // nested segments are drawn with one map from the LED to the root strip.
+    // constant hues use span writes and sys(led) hues write one LED at a time
+    const char * hues[] = {"120",R"json(["*","sys(led)",40])json"};
+    for(int h=0;h<2;h++) {
+        CaptureStrip* nestedCapture = new CaptureStrip(100);
+        CaptureStrip* flatCapture = new CaptureStrip(100);
+        HSLStrip nestedStrip(nestedCapture);
+        HSLStrip flatStrip(flatCapture);
+        char text[1000];
+        snprintf(text,sizeof(text),NESTED_MAP_SCRIPT,hues[h]);
+        drawScript(text,&nestedStrip);
+        snprintf(text,sizeof(text),FLAT_MAP_SCRIPT,hues[h]);
+        drawScript(text,&flatStrip);
+        nestedStrip.show();
+        flatStrip.show();
+        result.assertTrue(nestedCapture->equals(flatCapture),"nested segments match flat position");
+        result.assertTrue(flatCapture->getColor(52).red+flatCapture->getColor(52).green+flatCapture->getColor(52).blue > 0,"LED drawn");
+    }
+}
+
+void ScriptTestSuite::bufferedCopies(TestResult& result) {
+    // the second child changes LEDs the first one buffered so the first is written before it
+    CaptureStrip* copyCapture = new CaptureStrip(120);
+    CaptureStrip* flatCapture = new CaptureStrip(120);
+    HSLStrip copyStrip(copyCapture);
+    HSLStrip flatStrip(flatCapture);
+    char text[1500];
+    snprintf(text,sizeof(text),COPY_SCRIPT,LAYERED_CHILDREN);
+    drawScript(text,&copyStrip);
+    snprintf(text,sizeof(text),FLAT_COPY_SCRIPT,LAYERED_CHILDREN,LAYERED_CHILDREN,LAYERED_CHILDREN);
+    drawScript(text,&flatStrip);
+    copyStrip.show();
+    flatStrip.show();
+    result.assertTrue(copyCapture->equals(flatCapture),"layered copies match segments");
+    const CRGB& color = copyCapture->getColor(95);
+    result.assertTrue(color.red+color.green+color.blue > 0,"last copy drawn");
+}
+
+void ScriptTestSuite::rotation(TestResult& result) {
+    CaptureStrip* capture = new CaptureStrip(20);
+    HSLStrip strip(capture);
+    strip.clear();
+    strip.fillHSL(0,3,200,100,50);
+    strip.show();
+    CRGB drawn = capture->getColor(0);
+    capture->resetCounts();
+    strip.setRotation(5);
+    strip.show();
+    result.assertEqual(capture->getSetCount(),6,"only moved LEDs are written");
+    result.assertTrue(capture->getColor(5).blue == drawn.blue && capture->getColor(7).blue == drawn.blue,"rotated forward");
+    result.assertEqual(capture->getColor(0).blue,0,"first LED moved");
+    strip.setRotation(-21);
+    strip.show();
+    result.assertTrue(capture->getColor(19).blue == drawn.blue && capture->getColor(1).blue == drawn.blue,"rotated backward");
+    result.assertEqual(capture->getColor(2).blue,0,"last LED wrapped");
+
+    // a script rotates the strip with a value.  the next script starts unrotated
+    CaptureStrip* flatCapture = new CaptureStrip(20);
+    HSLStrip flatStrip(flatCapture);
+    char text[1000];
+    snprintf(text,sizeof(text),ROTATE_SCRIPT,"[\"+\",4,4]");
+    drawScript(text,&strip);
+    result.assertEqual(strip.getRotation(),8,"script rotation");
+    snprintf(text,sizeof(text),ROTATE_SCRIPT,"0");
+    drawScript(text,&flatStrip);
+    flatStrip.setRotation(8);
+    flatStrip.show();
+    result.assertTrue(capture->equals(flatCapture),"script rotation matches strip rotation");
+    drawScript(HSL_SIMPLE_SCRIPT,&strip);
+    result.assertEqual(strip.getRotation(),0,"rotation reset");
+}
+
+void ScriptTestSuite::rangeValues(TestResult& result) {
+    RootContext root;
+    root.setParams(NULL);
+    root.setValue("rangeVar",createValue(R"json(["*","sys(led)",2])json"));
+    root.getAnimationPositionDomain()->setPosition(0,0,39);
+
+    result.assertTrue(rangeMatches(R"json("sys(led)")json",&root,16,16),"sys(led)");
+    result.assertTrue(rangeMatches(R"json(["+",["*","sys(led)",3],["%","sys(led)",7]])json",&root,16,16),"function");
+    result.assertTrue(rangeMatches(R"json(["/",100,["-","sys(led)",20]])json",&root,16,16),"divide by 0");
+    result.assertTrue(rangeMatches(R"json(["max",null,"sys(led)"])json",&root,32,8),"default");
+    result.assertTrue(rangeMatches(R"json({"range":[0,360]})json",&root,32,8),"range");
+    result.assertTrue(rangeMatches(R"json({"pattern":[0,60,120],"smooth":true})json",&root,0,16),"pattern");
+    result.assertTrue(rangeMatches(R"json(["-",{"range":[10,90]}])json",&root,16,16),"function of range");
+    result.assertTrue(rangeMatches(R"json(["+","var(rangeVar)","var(rangeMissing)|5"])json",&root,0,16),"variables");
+}
+
+void ScriptTestSuite::patternSegments(TestResult& result) {
+    RootContext root;
+    root.setParams(NULL);
+    root.getAnimationPositionDomain()->setPosition(0,0,99);
+    PositionDomain* domain = root.getAnimationPositionDomain();
+
+    // the pattern repeats every 20 LEDs.  the second pass uses the segments from the first
+    IScriptValue* steps = createValue(R"json({"pattern":[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19]})json");
+    bool match = true;
+    for(int pass=0;pass<2;pass++) {
+        for(int led=0;led<20;led++) {
+            domain->setPos(led);
+            if (steps->getIntValue(&root,-1) != led) {
+                match = false;
+            }
+        }
+    }
+    result.assertTrue(match,"step pattern");
+    steps->destroy();
+
+    IScriptValue* smooth = createValue(R"json({"pattern":[0,100,200,300,400,500,600,700,800,900],"smooth":true})json");
+    const int expect[] = {0,66,150,250,350,450,550,650,750,833};
+    match = true;
+    for(int pass=0;pass<2;pass++) {
+        for(int led=0;led<10;led++) {
+            domain->setPos(led);
+            if (smooth->getIntValue(&root,-1) != expect[led]) {
+                match = false;
+            }
+        }
+    }
+    result.assertTrue(match,"smooth pattern");
+    smooth->destroy();
+}
+
+void ScriptTestSuite::scriptArena(TestResult& result) {
+    char text[1000];
+    snprintf(text,sizeof(text),NESTED_MAP_SCRIPT,"200");
+    ScriptDataLoader loader;
+    Script* script = loader.parse(text);
+    Arena* arena = script->getArena();
+    result.assertTrue(Arena::isArenaMemory(script->getRootContainer()),"elements are in the arena");
+    result.assertEqual(arena->getChunkCount(),1,"first pass reserved enough");
+    result.assertTrue(arena->getUsed() > 0 && arena->getUsed() <= arena->getSize(),"arena used");
+
+    // values created after loading are not in the arena
+    IScriptValue* value = createValue("10");
+    result.assertTrue(!Arena::isArenaMemory(value),"value outside of arena");
+    value->destroy();
+
+    CaptureStrip* capture = new CaptureStrip(60);
+    HSLStrip strip(capture);
+    script->begin(&strip,NULL);
+    script->step();
+    result.assertTrue(capture->getColor(50).blue > 0,"arena script draws");
+    script->destroy();
+
+    script = loader.parse(FRAME_VALUES_SCRIPT);
+    result.assertEqual(script->getArena()->getChunkCount(),1,"timer and values fit");
+    script->destroy();
+}
+
+#ifdef FAKE_ARDUINO
+void ScriptTestSuite::frameAllocations(TestResult& result) {
+    CaptureStrip* capture = new CaptureStrip(40);
+    HSLStrip strip(capture);
+    ScriptDataLoader loader;
+    Script* script = loader.parse(FRAME_VALUES_SCRIPT);
+    script->begin(&strip,NULL);
+    // the first frames create each value and run the timer through both states
+    for(int i=0;i<15;i++) {
+        script->step();
+        delay(2);
+    }
+    size_t allocs = EspBoard.getAllocationCount();
+    for(int i=0;i<30;i++) {
+        script->step();
+        delay(2);
+    }
+    result.assertEqual((int)(EspBoard.getAllocationCount()-allocs),0,"steps do not allocate");
+    script->destroy();
+}
+#endif
 
 }
 #endif 
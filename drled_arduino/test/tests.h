@@ -12,6 +12,8 @@
 #include "./script_suite.h"
 #include "./app_state_suite.h"
 #include "./timer_suite.h"
+#include "./animation_suite.h"
+#include "./color_suite.h"
 #endif 
 
 namespace DevRelief {
@@ -60,6 +62,9 @@ namespace DevRelief {
             #if RUN_ANIMATION_TESTS==1
             success = AnimationTestSuite::Run(m_logger) && success;
             #endif
+            #if RUN_COLOR_TESTS==1
+            success = ColorTestSuite::Run(m_logger) && success;
+            #endif
             #if SCRIPT_LOADER_TESTS==1
             success = ScriptLoaderTestSuite::Run(m_logger) && success;
             #endif
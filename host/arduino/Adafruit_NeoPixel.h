@@ -0,0 +1,128 @@
+#ifndef HOST_ADAFRUIT_NEOPIXEL_H
+#define HOST_ADAFRUIT_NEOPIXEL_H
+
+// Simulated Adafruit_NeoPixel for host builds.
+// Pixels are kept in an in-memory buffer with the same byte order
+// and brightness scaling as the real driver.  show() only counts frames.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint16_t neoPixelType;
+
+// color order: offset of each color within a pixel (W,R,G,B)
+#define NEO_RGB  ((0<<6) | (0<<4) | (1<<2) | (2))
+#define NEO_RBG  ((0<<6) | (0<<4) | (2<<2) | (1))
+#define NEO_GRB  ((1<<6) | (1<<4) | (0<<2) | (2))
+#define NEO_GBR  ((2<<6) | (2<<4) | (0<<2) | (1))
+#define NEO_BRG  ((1<<6) | (1<<4) | (2<<2) | (0))
+#define NEO_BGR  ((2<<6) | (2<<4) | (1<<2) | (0))
+#define NEO_RGBW ((3<<6) | (0<<4) | (1<<2) | (2))
+#define NEO_GRBW ((3<<6) | (1<<4) | (0<<2) | (2))
+
+#define NEO_KHZ800 0x0000
+#define NEO_KHZ400 0x0100
+
+class Adafruit_NeoPixel {
+    public:
+        Adafruit_NeoPixel(uint16_t n, int16_t pin=6, neoPixelType type=NEO_GRB + NEO_KHZ800) {
+            m_pin = pin;
+            m_brightness = 0;
+            m_begun = false;
+            m_showCount = 0;
+            m_pixels = NULL;
+            m_numLEDs = 0;
+            m_numBytes = 0;
+            updateType(type);
+            updateLength(n);
+        }
+
+        ~Adafruit_NeoPixel() {
+            free(m_pixels);
+        }
+
+        void begin() { m_begun = true;}
+        void show() { m_showCount++;}
+        bool canShow() { return true;}
+
+        void updateLength(uint16_t n) {
+            free(m_pixels);
+            m_numBytes = n * (m_wOffset == m_rOffset ? 3 : 4);
+            m_pixels = (uint8_t*)calloc(m_numBytes ? m_numBytes : 1,1);
+            m_numLEDs = n;
+        }
+
+        void updateType(neoPixelType type) {
+            m_wOffset = (type >> 6) & 0b11;
+            m_rOffset = (type >> 4) & 0b11;
+            m_gOffset = (type >> 2) & 0b11;
+            m_bOffset = type & 0b11;
+        }
+
+        void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+            if (n >= m_numLEDs) { return;}
+            if (m_brightness) {
+                r = (r * m_brightness) >> 8;
+                g = (g * m_brightness) >> 8;
+                b = (b * m_brightness) >> 8;
+            }
+            uint8_t* p = pixel(n);
+            p[m_rOffset] = r;
+            p[m_gOffset] = g;
+            p[m_bOffset] = b;
+        }
+
+        void setPixelColor(uint16_t n, uint32_t c) {
+            setPixelColor(n,(uint8_t)(c >> 16),(uint8_t)(c >> 8),(uint8_t)c);
+        }
+
+        // returns the stored (brightness scaled) color
+        uint32_t getPixelColor(uint16_t n) const {
+            if (n >= m_numLEDs) { return 0;}
+            const uint8_t* p = m_pixels + n * bytesPerPixel();
+            return ((uint32_t)p[m_rOffset] << 16) | ((uint32_t)p[m_gOffset] << 8) | p[m_bOffset];
+        }
+
+        void fill(uint32_t c=0, uint16_t first=0, uint16_t count=0) {
+            uint16_t end = count == 0 || first+count > m_numLEDs ? m_numLEDs : first+count;
+            for(uint16_t i=first;i<end;i++) {
+                setPixelColor(i,c);
+            }
+        }
+
+        // brightness is stored +1 so 0 means "not scaled" like the real driver
+        void setBrightness(uint8_t b) { m_brightness = b+1;}
+        uint8_t getBrightness() const { return m_brightness-1;}
+
+        void clear() { memset(m_pixels,0,m_numBytes);}
+        uint8_t* getPixels() const { return m_pixels;}
+        uint16_t numPixels() const { return m_numLEDs;}
+        int16_t getPin() const { return m_pin;}
+        void setPin(int16_t pin) { m_pin = pin;}
+
+        static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+            return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+        }
+
+        // host only: number of times show() was called
+        unsigned long getShowCount() const { return m_showCount;}
+
+    private:
+        uint8_t bytesPerPixel() const { return m_wOffset == m_rOffset ? 3 : 4;}
+        uint8_t* pixel(uint16_t n) { return m_pixels + n * bytesPerPixel();}
+
+        uint16_t m_numLEDs;
+        uint16_t m_numBytes;
+        int16_t m_pin;
+        uint8_t m_brightness;
+        uint8_t* m_pixels;
+        uint8_t m_rOffset;
+        uint8_t m_gOffset;
+        uint8_t m_bOffset;
+        uint8_t m_wOffset;
+        bool m_begun;
+        unsigned long m_showCount;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal Arduino core for host (Linux) builds.
+// Only what the drled firmware uses is implemented.
+// The host build force-includes this file the same way the Arduino IDE
+// implicitly includes Arduino.h in a sketch.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+
+#ifndef FAKE_ARDUINO
+#define FAKE_ARDUINO
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef unsigned long ulong;
+
+#define F(text) (text)
+#define PSTR(text) (text)
+#define PROGMEM
+#define ICACHE_RAM_ATTR
+#define IRAM_ATTR
+
+#define WDTO_4S 4000
+#define PI 3.1415926535897932384626433832795
+inline void wdt_enable(int msecs) {}
+inline void wdt_reset() {}
+inline void yield() {}
+
+// time is relative to the first call so values stay small like on the device.
+inline uint64_t hostMicros() {
+    static struct timespec start = {0,0};
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC,&now);
+    if (start.tv_sec == 0 && start.tv_nsec == 0) {
+        start = now;
+    }
+    return (uint64_t)(now.tv_sec-start.tv_sec)*1000000 + (now.tv_nsec-start.tv_nsec)/1000;
+}
+
+inline unsigned long millis() { return (unsigned long)(hostMicros()/1000);}
+inline unsigned long micros() { return (unsigned long)hostMicros();}
+inline void delay(unsigned long msecs) { usleep(msecs*1000);}
+inline void delayMicroseconds(unsigned int usecs) { usleep(usecs);}
+
+inline void randomSeed(unsigned long seed) { srand(seed);}
+inline long random(long high) { return high <= 0 ? 0 : rand() % high;}
+inline long random(long low, long high) { return high <= low ? low : low + rand() % (high-low);}
+inline int analogRead(uint8_t pin) { return 0;}
+
+template<typename A, typename B> inline auto min(A a, B b) -> decltype(a<b ? a : b) { return a < b ? a : b;}
+template<typename A, typename B> inline auto max(A a, B b) -> decltype(a>b ? a : b) { return a > b ? a : b;}
+#define _min(a,b) min(a,b)
+#define _max(a,b) max(a,b)
+
+class String {
+    public:
+        String(const char * text="") : m_text(text ? text : "") {}
+        String(const std::string& text) : m_text(text) {}
+        String(int val) : m_text(std::to_string(val)) {}
+
+        const char * c_str() const { return m_text.c_str();}
+        unsigned int length() const { return m_text.length();}
+        bool operator==(const char * other) const { return m_text == (other ? other : "");}
+        String& operator+=(const char * other) { m_text += other; return *this;}
+    private:
+        std::string m_text;
+};
+
+class Print {
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t c)=0;
+        virtual size_t write(const uint8_t* data, size_t len) {
+            size_t n = 0;
+            while(len--) { n += write(*data++);}
+            return n;
+        }
+        size_t write(const char * text) { return text ? write((const uint8_t*)text,strlen(text)) : 0;}
+        size_t print(const char * text) { return write(text);}
+        size_t println(const char * text="") { return write(text) + write((const uint8_t*)"\n",1);}
+        size_t printf(const char * format, ...) {
+            char buf[512];
+            va_list args;
+            va_start(args,format);
+            vsnprintf(buf,sizeof(buf),format,args);
+            va_end(args);
+            return write(buf);
+        }
+        virtual void flush() {}
+};
+
+class Printable {
+    public:
+        virtual ~Printable() {}
+        virtual size_t printTo(Print& p) const = 0;
+};
+
+// Serial writes to stdout.
+class HostSerial : public Print {
+    public:
+        using Print::write;
+        void begin(unsigned long baud) {}
+        size_t write(uint8_t c) override { return fputc(c,stdout) == EOF ? 0 : 1;}
+        size_t write(const uint8_t* data, size_t len) override { return fwrite(data,1,len,stdout);}
+        void flush() override { fflush(stdout);}
+        operator bool() const { return true;}
+};
+
+inline HostSerial Serial;
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef HOST_ESP8266WEBSERVER_H
+#define HOST_ESP8266WEBSERVER_H
+
+// ESP8266WebServer for host builds.  Routes are accepted and ignored;
+// no requests are ever received.
+
+#include <functional>
+
+typedef enum {
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS
+} HTTPMethod;
+
+class Uri {
+    public:
+        Uri(const char * uri) : m_uri(uri) {}
+        virtual ~Uri() {}
+    protected:
+        String m_uri;
+};
+
+class WiFiClient {
+    public:
+        operator bool() const { return false;}
+        void keepAlive() {}
+};
+
+class ESP8266WebServer {
+    public:
+        typedef std::function<void(void)> THandlerFunction;
+
+        ESP8266WebServer(int port=80) {}
+
+        void begin() {}
+        void handleClient() {}
+        WiFiClient& client() { return m_client;}
+
+        void on(const Uri& uri, THandlerFunction handler) {}
+        void on(const Uri& uri, HTTPMethod method, THandlerFunction handler) {}
+        void onNotFound(THandlerFunction handler) {}
+
+        String uri() const { return String("");}
+        HTTPMethod method() const { return HTTP_GET;}
+        String arg(const char * name) const { return String("");}
+        String arg(int i) const { return String("");}
+        String argName(int i) const { return String("");}
+        int args() const { return 0;}
+        String pathArg(unsigned int i) const { return String("");}
+
+        void sendHeader(const char * name, const char * value, bool first=false) {}
+        void send(int code, const char * contentType=NULL, const char * content=NULL) {}
+    private:
+        WiFiClient m_client;
+};
+
+#endif
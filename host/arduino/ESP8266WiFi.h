@@ -0,0 +1,42 @@
+#ifndef HOST_ESP8266WIFI_H
+#define HOST_ESP8266WIFI_H
+
+// WiFi for host builds.  There is no network so the station never connects.
+
+#include <stdio.h>
+#include <stdint.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class IPAddress {
+    public:
+        IPAddress(uint8_t a=0, uint8_t b=0, uint8_t c=0, uint8_t d=0) {
+            m_bytes[0] = a; m_bytes[1] = b; m_bytes[2] = c; m_bytes[3] = d;
+        }
+
+        String toString() const {
+            char text[16];
+            snprintf(text,sizeof(text),"%d.%d.%d.%d",m_bytes[0],m_bytes[1],m_bytes[2],m_bytes[3]);
+            return String(text);
+        }
+    private:
+        uint8_t m_bytes[4];
+};
+
+class HostWiFi {
+    public:
+        wl_status_t begin(const char * ssid, const char * password) { return WL_DISCONNECTED;}
+        wl_status_t status() { return WL_DISCONNECTED;}
+        bool hostname(const char * name) { return true;}
+        IPAddress localIP() { return IPAddress(127,0,0,1);}
+};
+
+inline HostWiFi WiFi;
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef HOST_ESP8266MDNS_H
+#define HOST_ESP8266MDNS_H
+
+class HostMDNS {
+    public:
+        bool begin(const char * hostname) { return true;}
+        void update() {}
+        void addService(const char * service, const char * proto, uint16_t port) {}
+};
+
+inline HostMDNS MDNS;
+
+#endif
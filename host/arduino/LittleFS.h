@@ -0,0 +1,133 @@
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+// LittleFS for host builds.  Files live in a directory on the host
+// file system: $DRLED_FS_ROOT if set, otherwise ./littlefs
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string>
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+class File {
+    public:
+        File(FILE* fp=NULL) { m_fp = fp;}
+
+        operator bool() const { return m_fp != NULL;}
+        bool isFile() const { return m_fp != NULL;}
+
+        size_t size() const {
+            if (m_fp == NULL) { return 0;}
+            long pos = ftell(m_fp);
+            fseek(m_fp,0,SEEK_END);
+            long len = ftell(m_fp);
+            fseek(m_fp,pos,SEEK_SET);
+            return len;
+        }
+
+        bool seek(size_t pos, SeekMode mode=SeekSet) {
+            return m_fp && fseek(m_fp,pos,mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END) == 0;
+        }
+
+        size_t read(uint8_t* buf, size_t len) { return m_fp ? fread(buf,1,len,m_fp) : 0;}
+        size_t read(char* buf, size_t len) { return read((uint8_t*)buf,len);}
+        int read() { return m_fp ? fgetc(m_fp) : -1;}
+        int available() { return m_fp ? (int)(size()-ftell(m_fp)) : 0;}
+
+        size_t write(const uint8_t* data, size_t len) { return m_fp ? fwrite(data,1,len,m_fp) : 0;}
+        size_t write(const char* data, size_t len) { return write((const uint8_t*)data,len);}
+
+        void close() {
+            if (m_fp) { fclose(m_fp);}
+            m_fp = NULL;
+        }
+    private:
+        FILE* m_fp;
+};
+
+class Dir {
+    public:
+        Dir(const std::string& path="") {
+            m_dir = path.empty() ? NULL : opendir(path.c_str());
+        }
+
+        bool next() {
+            if (m_dir == NULL) { return false;}
+            struct dirent* entry;
+            while((entry = readdir(m_dir)) != NULL) {
+                if (entry->d_name[0] != '.') {
+                    m_name = entry->d_name;
+                    return true;
+                }
+            }
+            closedir(m_dir);
+            m_dir = NULL;
+            return false;
+        }
+
+        String fileName() const { return String(m_name);}
+    private:
+        DIR* m_dir;
+        std::string m_name;
+};
+
+class HostLittleFS {
+    public:
+        bool begin() {
+            const char * root = getenv("DRLED_FS_ROOT");
+            m_root = root ? root : "littlefs";
+            mkdir(m_root.c_str(),0755);
+            return true;
+        }
+
+        bool exists(const char * path) {
+            struct stat st;
+            return stat(hostPath(path).c_str(),&st) == 0;
+        }
+
+        bool remove(const char * path) { return ::remove(hostPath(path).c_str()) == 0;}
+
+        File open(const char * path, const char * mode) {
+            std::string full = hostPath(path);
+            if (mode[0] != 'r') {
+                makeParents(full);
+            }
+            struct stat st;
+            if (mode[0] == 'r' && (stat(full.c_str(),&st) != 0 || !S_ISREG(st.st_mode))) {
+                return File();
+            }
+            return File(fopen(full.c_str(),mode[0] == 'r' ? "rb" : mode[0] == 'a' ? "ab" : "wb"));
+        }
+
+        Dir openDir(const char * path) { return Dir(hostPath(path));}
+
+    private:
+        std::string hostPath(const char * path) {
+            if (m_root.empty()) { begin();}
+            std::string full = m_root;
+            if (path == NULL || path[0] != '/') {
+                full += "/";
+            }
+            return full + (path ? path : "");
+        }
+
+        void makeParents(const std::string& path) {
+            for(size_t pos = path.find('/',1);pos != std::string::npos;pos = path.find('/',pos+1)) {
+                mkdir(path.substr(0,pos).c_str(),0755);
+            }
+        }
+
+        std::string m_root;
+};
+
+inline HostLittleFS LittleFS;
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef HOST_NTPCLIENT_H
+#define HOST_NTPCLIENT_H
+
+// NTPClient for host builds uses the host clock.
+
+#include <time.h>
+#include "./WiFiUdp.h"
+
+class NTPClient {
+    public:
+        NTPClient(WiFiUDP& udp, const char * poolServerName) {}
+
+        void begin() {}
+        bool update() { return true;}
+        unsigned long getEpochTime() const { return (unsigned long)time(NULL);}
+};
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef HOST_WIFIUDP_H
+#define HOST_WIFIUDP_H
+
+class WiFiUDP {
+    public:
+        uint8_t begin(uint16_t port) { return 0;}
+        void stop() {}
+};
+
+#endif
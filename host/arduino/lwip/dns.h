@@ -0,0 +1,14 @@
+#ifndef HOST_LWIP_DNS_H
+#define HOST_LWIP_DNS_H
+
+#include <stdint.h>
+
+typedef struct ip_addr {
+    uint32_t addr;
+} ip_addr_t;
+
+#define IP4_ADDR(ipaddr,a,b,c,d) (ipaddr)->addr = ((uint32_t)(d) << 24) | ((uint32_t)(c) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(a)
+
+inline void dns_setserver(uint8_t numdns, const ip_addr_t* dnsserver) {}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef HOST_URI_BRACES_H
+#define HOST_URI_BRACES_H
+
+#include "../ESP8266WebServer.h"
+
+class UriBraces : public Uri {
+    public:
+        UriBraces(const char * uri) : Uri(uri) {}
+};
+
+#endif
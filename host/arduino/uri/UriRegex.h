@@ -0,0 +1,11 @@
+#ifndef HOST_URI_REGEX_H
+#define HOST_URI_REGEX_H
+
+#include "../ESP8266WebServer.h"
+
+class UriRegex : public Uri {
+    public:
+        UriRegex(const char * uri) : Uri(uri) {}
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef DRWIFIFCREDENTIALS_H
+#define DRWIFIFCREDENTIALS_H
+
+// host builds never connect; lib/net/wifi_credentials.h is used when it exists.
+
+namespace DevRelief {
+    const char* wifi_ssid = "";
+    const char* wifi_password = "";
+}
+
+#endif
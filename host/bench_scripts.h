@@ -0,0 +1,133 @@
+#ifndef HOST_BENCH_SCRIPTS_H
+#define HOST_BENCH_SCRIPTS_H
+
+// Stress scripts used by drled_bench.
+// Each one exercises a different part of the draw path.  All use
+// "frequency": 0 so every Script::step() draws a frame.
+
+namespace DevRelief {
+
+// ScriptSegmentContainer nested 8 deep.  Each level has its own
+// position and an hsl child so every level draws.
+const char * BENCH_NESTED_SEGMENTS = R"script(
+{
+    "name": "nested-segments",
+    "frequency": 0,
+    "elements": [
+    { "type": "segment", "unit": "percent", "offset": 2, "length": 96, "elements": [
+        { "type": "hsl", "hue": 0, "lightness": 20 },
+        { "type": "segment", "unit": "percent", "offset": 3, "length": 94, "elements": [
+            { "type": "hsl", "hue": 40, "op": "add" },
+            { "type": "segment", "unit": "percent", "offset": 3, "length": 94, "reverse": true, "elements": [
+                { "type": "hsl", "hue": 80, "saturation": 90 },
+                { "type": "segment", "unit": "percent", "offset": 3, "length": 94, "elements": [
+                    { "type": "hsl", "hue": 120, "op": "average" },
+                    { "type": "segment", "unit": "percent", "offset": 3, "length": 94, "wrap": true, "elements": [
+                        { "type": "hsl", "hue": 160, "lightness": 40 },
+                        { "type": "segment", "unit": "percent", "offset": 3, "length": 94, "elements": [
+                            { "type": "hsl", "hue": 200, "op": "max" },
+                            { "type": "segment", "unit": "percent", "offset": 3, "length": 94, "elements": [
+                                { "type": "hsl", "hue": 240 },
+                                { "type": "segment", "unit": "percent", "offset": 3, "length": 94, "elements": [
+                                    { "type": "hsl", "hue": { "range": [0, 360] }, "lightness": 50 }
+                                ]}
+                            ]}
+                        ]}
+                    ]}
+                ]}
+            ]}
+        ]}
+    ]}
+    ]
+}
+)script";
+
+// many hsl elements, each with PatternValue hue/lightness/saturation
+const char * BENCH_HSL_PATTERNS = R"script(
+{
+    "name": "hsl-patterns",
+    "frequency": 0,
+    "elements": [
+    { "type": "hsl", "hue": { "range": [0, 360] }, "lightness": { "pattern": ["10x3", "50x3", "90x3"] } },
+    { "type": "hsl", "op": "add", "hue": { "pattern": [0, 60, 120, 180, 240, 300] } },
+    { "type": "hsl", "op": "average", "lightness": { "range": [10, 90, 10], "unfold": true } },
+    { "type": "hsl", "op": "max", "saturation": { "pattern": ["100x5", "60x5"] } },
+    { "type": "hsl", "unit": "percent", "offset": 10, "length": 30, "hue": { "range": [120, 240], "ease": 0.5 } },
+    { "type": "hsl", "unit": "percent", "offset": 40, "length": 30, "hue": { "range": [240, 360], "ease-in": 0.3, "ease-out": 0.8 } },
+    { "type": "hsl", "unit": "percent", "offset": 70, "length": 30, "lightness": { "pattern": [20, 40, 60, 80], "smooth": true } },
+    { "type": "hsl", "op": "min", "lightness": { "range": [100, 0], "duration": 2000, "repeat": true } },
+    { "type": "hsl", "op": "add", "hue": { "range": [0, 360], "speed": 50 } },
+    { "type": "hsl", "op": "average", "hue": { "pattern": ["0x2", "90x2", "180x2", "270x2"], "unfold": true } },
+    { "type": "hsl", "op": "max", "lightness": ["rand", 10, 60] },
+    { "type": "hsl", "op": "average", "saturation": { "range": [50, 100, 50] } },
+    { "type": "hsl", "op": "add", "hue": ["mod", "sys(led)", 360] },
+    { "type": "rhsl", "op": "average", "unit": "percent", "offset": 0, "length": 50 },
+    { "type": "hsl", "op": "min", "hue": { "pattern": [30, 60, 90], "smooth": true }, "lightness": { "range": [30, 70] } },
+    { "type": "hsl", "op": "max", "hue": ["add", { "range": [0, 180] }, 90] }
+    ]
+}
+)script";
+
+// MakerContainer with a high count of concurrent child contexts
+const char * BENCH_MAKER = R"script(
+{
+    "name": "maker",
+    "frequency": 0,
+    "elements": [
+    { "type": "hsl", "hue": 200, "lightness": 10 },
+    { "type": "maker", "count": 32, "max-duration": 1000,
+        "init": { "pos": ["rand", 0, 90], "color": ["rand", 0, 360] },
+        "unit": "percent", "offset": "var(pos)", "length": 10,
+        "elements": [
+        { "type": "hsl", "hue": "var(color)", "lightness": { "range": [10, 60, 10] } },
+        { "type": "hsl", "op": "add", "saturation": { "pattern": [100, 50] } }
+        ]
+    }
+    ]
+}
+)script";
+
+// Mirror / Copy / Repeat chained inside each other
+const char * BENCH_STRIP_CHAIN = R"script(
+{
+    "name": "strip-chain",
+    "frequency": 0,
+    "elements": [
+    { "type": "mirror", "elements": [
+        { "type": "copy", "count": 4, "elements": [
+            { "type": "repeat", "elements": [
+                { "type": "hsl", "length": 5, "hue": { "range": [0, 120] } },
+                { "type": "hsl", "length": 3, "hue": 240, "lightness": 20 }
+            ]},
+            { "type": "mirror", "elements": [
+                { "type": "hsl", "op": "add", "hue": { "pattern": [0, 90, 180, 270] } }
+            ]}
+        ]}
+    ]},
+    { "type": "copy", "count": 3, "elements": [
+        { "type": "repeat", "elements": [
+            { "type": "copy", "count": 2, "elements": [
+                { "type": "hsl", "length": 4, "op": "average", "lightness": { "range": [10, 90] } }
+            ]}
+        ]}
+    ]}
+    ]
+}
+)script";
+
+struct BenchScript {
+    const char * name;
+    const char * text;
+};
+
+const BenchScript BENCH_SCRIPTS[] = {
+    {"nested-segments",BENCH_NESTED_SEGMENTS},
+    {"hsl-patterns",BENCH_HSL_PATTERNS},
+    {"maker",BENCH_MAKER},
+    {"strip-chain",BENCH_STRIP_CHAIN},
+    {NULL,NULL}
+};
+
+}
+
+#endif
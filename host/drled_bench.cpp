@@ -0,0 +1,97 @@
+// Frame rendering benchmark.
+// Runs each stress script in bench_scripts.h on the same strip setup the
+// firmware uses (ScriptExecutor -> HSLStrip -> CompoundLedStrip -> PhyisicalLedStrip)
+// and reports the cost of Script::step() (clear, root container draw, show).
+//
+//   drled_bench [frames] [script name]
+//
+// Output is one JSON object per line:
+//   {"script":"maker","leds":300,"frames":200,"ns_per_frame":...,"ns_per_led":...,"allocs_per_frame":...}
+
+#include <chrono>
+#include "../drled_arduino/env.h"
+#include "../drled_arduino/lib/log/logger.h"
+#include "../drled_arduino/lib/log/config.h"
+#include "../drled_arduino/loggers.h"
+#include "../drled_arduino/script/script.h"
+#include "../drled_arduino/script/executor.h"
+#include "../drled_arduino/script/data_loader.h"
+#include "../drled_arduino/config.h"
+#include "./bench_scripts.h"
+
+using namespace DevRelief;
+
+const int BENCH_LED_COUNTS[] = {60,300,1200,5000,0};
+const int BENCH_WARMUP_FRAMES = 5;
+const int BENCH_PIN = 5;
+
+bool benchScript(const BenchScript& bench, int ledCount, long frames) {
+    Config config;
+    config.addPin(BENCH_PIN,ledCount);
+    Config::setInstance(&config);
+
+    ScriptExecutor executor;
+    executor.configChange(config);
+
+    ScriptDataLoader loader;
+    Script* script = loader.parse(bench.text);
+    if (script == NULL) {
+        fprintf(stderr,"cannot parse script %s\n",bench.name);
+        Config::setInstance(NULL);
+        return false;
+    }
+    // draw on every step regardless of the script's frequency
+    script->setFrequency(0);
+    executor.setScript(script);
+
+    for(int i=0;i<BENCH_WARMUP_FRAMES;i++) {
+        executor.step();
+    }
+
+    size_t startAllocs = EspBoard.getAllocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for(long i=0;i<frames;i++) {
+        executor.step();
+    }
+    auto end = std::chrono::steady_clock::now();
+    size_t allocs = EspBoard.getAllocationCount() - startAllocs;
+
+    double ns = std::chrono::duration<double,std::nano>(end-start).count();
+    double nsPerFrame = ns/frames;
+    printf("{\"script\":\"%s\",\"leds\":%d,\"frames\":%ld,\"ns_per_frame\":%.0f,\"ns_per_led\":%.2f,\"allocs_per_frame\":%.2f}\n",
+        bench.name,ledCount,frames,nsPerFrame,nsPerFrame/ledCount,(double)allocs/frames);
+    fflush(stdout);
+
+    executor.endScript();
+    Config::setInstance(NULL);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    long frames = argc > 1 ? atol(argv[1]) : 200;
+    const char * only = argc > 2 ? argv[2] : NULL;
+    if (frames <= 0) {
+        fprintf(stderr,"usage: drled_bench [frames] [script name]\n");
+        return 2;
+    }
+    ILogConfig* logConfig = new LogConfig(new LogSerialDestination(), new LogDefaultFilter(ERROR_LEVEL));
+
+    bool success = true;
+    int count = 0;
+    for(int s=0;BENCH_SCRIPTS[s].name != NULL;s++) {
+        if (only && strcmp(only,BENCH_SCRIPTS[s].name) != 0) {
+            continue;
+        }
+        for(int l=0;BENCH_LED_COUNTS[l] > 0;l++) {
+            // same random sequence for every run so "rand" values are repeatable
+            randomSeed(1);
+            success = benchScript(BENCH_SCRIPTS[s],BENCH_LED_COUNTS[l],frames) && success;
+        }
+        count++;
+    }
+    if (count == 0) {
+        fprintf(stderr,"unknown script %s\n",only);
+        return 2;
+    }
+    return success ? 0 : 1;
+}
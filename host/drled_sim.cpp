@@ -0,0 +1,15 @@
+// Runs the complete firmware on the host: setup() followed by loop().
+// Strips are simulated in memory and LittleFS maps to $DRLED_FS_ROOT.
+//
+//   drled_sim [loop count]     (default runs until killed)
+
+#include "../drled_arduino/drled_arduino.ino"
+
+int main(int argc, char** argv) {
+    long loops = argc > 1 ? atol(argv[1]) : -1;
+    setup();
+    for(long i=0;loops < 0 || i<loops;i++) {
+        loop();
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+// Runs the firmware test suites (drled_arduino/test) on the host.
+// Exit code is non-zero if any suite fails or leaks memory.
+
+#include "../drled_arduino/env.h"
+#include "../drled_arduino/lib/log/logger.h"
+#include "../drled_arduino/lib/log/config.h"
+#include "../drled_arduino/loggers.h"
+#include "../drled_arduino/test/tests.h"
+
+using namespace DevRelief;
+
+int main(int argc, char** argv) {
+    ILogConfig* logConfig = new LogConfig(new LogSerialDestination(), new LogDefaultFilter(WARN_LEVEL));
+    Tests tests;
+    bool success = tests.run();
+    printf("\ndrled tests %s\n",success ? "passed" : "FAILED");
+    return success ? 0 : 1;
+}